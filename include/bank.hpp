@@ -3,11 +3,18 @@
 
 #include <eosio/eosio.hpp>
 #include <eosio/asset.hpp>
+#include <eosio/crypto.hpp>
+#include <eosio/datastream.hpp>
 #include <eosio/singleton.hpp>
 #include <eosio/multi_index.hpp>
 
 #include "eosiotoken.hpp"
 #include "common.hpp"
+#include "config.hpp"
+#include "eraser.hpp"
+#include "errors.hpp"
+#include "logger.hpp"
+#include "sequence.hpp"
 
 using namespace eosio;
 using std::string;
@@ -17,22 +24,6 @@ class Bank {
 
     public:
 
-        struct [[eosio::table, eosio::contract("dao") ]] Config 
-        {
-            // required configurations:
-            // names : telos_decide_contract, reward_token_contract, seeds_token_contract, last_ballot_id
-            // ints  : voting_duration_sec
-            map<string, name>          names             ;
-            map<string, string>        strings           ;
-            map<string, asset>         assets            ;
-            map<string, time_point>    time_points       ;
-            map<string, uint64_t>      ints              ;
-            map<string, transaction>   trxs              ;
-            map<string, float>         floats            ;
-        };
-
-        typedef singleton<"config"_n, Config> config_table;
-
         struct [[eosio::table, eosio::contract("dao") ]] Period
         {
             uint64_t         period_id               ;
@@ -40,13 +31,15 @@ class Bank {
             time_point       end_date                ;
 
             uint64_t        primary_key()  const { return period_id; }
+            uint64_t        by_start ()    const { return start_date.sec_since_epoch(); }
+            uint64_t        by_end ()      const { return end_date.sec_since_epoch(); }
         };
 
         struct [[eosio::table, eosio::contract("dao") ]] Payment
         {
             uint64_t        payment_id              ;
             time_point      payment_date            ;
-            uint64_t        period_id               = 0;
+            uint64_t        period_id               = common::NO_PERIOD;
             uint64_t        assignment_id           = -1;
             name            recipient               ;
             asset           amount                  ;
@@ -58,74 +51,125 @@ class Bank {
             uint64_t        by_assignment() const { return assignment_id; }
         };
 
-        typedef multi_index<"periods"_n, Period> period_table;
+        // scope: symbol code of the amount; one row per (recipient, period).
+        // The row with an empty recipient holds the total paid in the period.
+        struct [[eosio::table, eosio::contract("dao") ]] PaymentRollup
+        {
+            uint64_t        rollup_id               ;
+            name            recipient               ;
+            uint64_t        period_id               = 0;
+            asset           amount                  ;
+            uint64_t        payment_count           = 0;
+            time_point      updated_date            = current_time_point();
 
-        typedef multi_index<"payments"_n, Payment,
-            indexed_by<"byperiod"_n, const_mem_fun<Payment, uint64_t, &Payment::by_period>>,
-            indexed_by<"byrecipient"_n, const_mem_fun<Payment, uint64_t, &Payment::by_recipient>>,
-            indexed_by<"byassignment"_n, const_mem_fun<Payment, uint64_t, &Payment::by_assignment>>
-        > payment_table;
+            uint64_t        primary_key()           const { return rollup_id; }
+            uint128_t       by_recipient_period()   const { return rollup_key (recipient, period_id); }
+            uint64_t        by_period ()            const { return period_id; }
+        };
 
-        struct [[eosio::table, eosio::contract("dao") ]] Debug
+        // Running record of payments removed by compact_payments. digest is the chain
+        // sha256(previous digest || packed Payment) over every removed row, in payment_id
+        // order, so an off-chain copy of the payments table can be checked against it.
+        struct [[eosio::table, eosio::contract("dao") ]] PaymentArchive
         {
-            uint64_t    debug_id;
-            string      notes;
-            time_point  created_date = current_time_point();
-            uint64_t    primary_key()  const { return debug_id; }
+            uint64_t        compacted_count         = 0;
+            uint64_t        last_payment_id         = 0;
+            checksum256     digest                  ;
+            time_point      updated_date            = current_time_point();
         };
 
-      typedef multi_index<"debugs"_n, Debug> debug_table;
+        // Regular periods computed instead of stored: period i (0 <= i < count) has id
+        // first_period_id + i and runs from epoch + i * length_sec to one second before the
+        // next one starts. A row in the periods table with a calendar id (written by overperiod)
+        // overrides that calendar period; addperiods keeps its ids and dates outside the calendar.
+        struct [[eosio::table, eosio::contract("dao") ]] PeriodCalendar
+        {
+            time_point      epoch                   ;
+            uint64_t        length_sec              = 0;
+            uint64_t        count                   = 0;
+            uint64_t        first_period_id         = 0;
+        };
 
+        typedef singleton<"calendar"_n, PeriodCalendar> calendar_table;
+        typedef multi_index<"calendar"_n, PeriodCalendar> calendar_table_placeholder;
 
-      void debug (const string& notes) {
-         debug_table d_t (contract, contract.value);
-         d_t.emplace (contract, [&](auto &d) {
-            d.debug_id = d_t.available_primary_key();
-            d.notes = notes;
-         });
-      }
+        typedef singleton<"payarchive"_n, PaymentArchive> payment_archive_table;
+        typedef multi_index<"payarchive"_n, PaymentArchive> payment_archive_table_placeholder;
 
+        static uint128_t rollup_key (const name& recipient, const uint64_t& period_id) {
+            return (uint128_t { recipient.value } << 64) | period_id;
+        }
+
+        typedef multi_index<"periods"_n, Period,
+            indexed_by<"bystartdate"_n, const_mem_fun<Period, uint64_t, &Period::by_start>>,
+            indexed_by<"byenddate"_n, const_mem_fun<Period, uint64_t, &Period::by_end>>
+        > period_table;
+
+        // view of the periods table without secondary indexes, used by migrate_periods to
+        // re-emplace rows written before the indexes existed
+        typedef multi_index<"periods"_n, Period> legacy_period_table;
+
+        typedef multi_index<"payrollups"_n, PaymentRollup,
+            indexed_by<"byrecperiod"_n, const_mem_fun<PaymentRollup, uint128_t, &PaymentRollup::by_recipient_period>>,
+            indexed_by<"byperiod"_n, const_mem_fun<PaymentRollup, uint64_t, &PaymentRollup::by_period>>
+        > rollup_table;
+
+        typedef multi_index<"payments"_n, Payment,
+            indexed_by<"byperiod"_n, const_mem_fun<Payment, uint64_t, &Payment::by_period>>,
+            indexed_by<"byrecipient"_n, const_mem_fun<Payment, uint64_t, &Payment::by_recipient>>,
+            indexed_by<"byassignment"_n, const_mem_fun<Payment, uint64_t, &Payment::by_assignment>>
+        > payment_table;
 
         name                contract;
         period_table        period_t;
         payment_table       payment_t;
-        config_table        config_s;
+        ConfigContext&      config;
+        Sequences&          sequences;
+        Logger&             logger;
+        BatchEraser         eraser;
 
-        Bank (const name& contract):
+        Bank (const name& contract, ConfigContext& config, Sequences& sequences, Logger& logger):
             contract (contract),
-            payment_t (contract, contract.value),
             period_t (contract, contract.value),
-            config_s (contract, contract.value) {}
+            payment_t (contract, contract.value),
+            config (config),
+            sequences (sequences),
+            logger (logger),
+            eraser (contract) {}
 
-       void reset () {
+        BatchEraser::Result reset (const uint64_t& max_rows) {
             require_auth (contract);
-            
-            auto pay_itr = payment_t.begin();
-            while (pay_itr != payment_t.end()) {
-                pay_itr = payment_t.erase (pay_itr);
-            }
+            BatchEraser::Result result = eraser.erase (payment_t, "reset"_n, contract, 0, std::numeric_limits<uint64_t>::max(), max_rows);
+            // payment ids keep counting from the paymentids sequence, so rollupfrom stays valid
+            return result;
         }
 
-        void remove_periods (const uint64_t& begin_period_id, 
-                           const uint64_t& end_period_id) {
+        BatchEraser::Result remove_periods (const uint64_t& begin_period_id, 
+                                            const uint64_t& end_period_id,
+                                            const uint64_t& max_rows) {
             require_auth (contract);
-
-            auto p_itr = period_t.find (begin_period_id);
-            check (p_itr != period_t.end(), "Begin period ID not found: " + std::to_string(begin_period_id));
-
-            while (p_itr->period_id <= end_period_id) {
-                p_itr = period_t.erase (p_itr);
-            }
+            // erasing a row through period_t needs its index entries
+            check (periods_migrated(), errors::PERIODS_NOT_MIGRATED);
+            check (begin_period_id <= end_period_id, errors::PERIOD_RANGE, begin_period_id, end_period_id);
+            return eraser.erase (period_t, "remperiods"_n, contract, begin_period_id, end_period_id, max_rows);
         }
 
-        void reset_periods() {
+        BatchEraser::Result reset_periods (const uint64_t& max_rows) {
             require_auth (contract);
-            auto per_itr = period_t.begin();
-            while (per_itr != period_t.end()) {
-                per_itr = period_t.erase (per_itr);
-            }
+            // erasing a row through period_t needs its index entries
+            check (periods_migrated(), errors::PERIODS_NOT_MIGRATED);
+            return eraser.erase (period_t, "resetperiods"_n, contract, 0, std::numeric_limits<uint64_t>::max(), max_rows);
         }
                           
+        // period_id of NO_PERIOD is resolved to the period containing the block time
+        struct PaymentRequest {
+            uint64_t        period_id               = common::NO_PERIOD;
+            name            recipient               ;
+            asset           quantity                ;
+            string          memo                    ;
+            uint64_t        assignment_id           = common::NO_ASSIGNMENT;
+        };
+
         void makepayment (const uint64_t& period_id, 
                             const name& recipient, 
                             const asset& quantity, 
@@ -133,79 +177,440 @@ class Bank {
                             const uint64_t& assignment_id,
                             const uint64_t& bypass_escrow) {
 
-            if (quantity.amount == 0) {
-                return;
+            makepayments ({ PaymentRequest { period_id, recipient, quantity, memo, assignment_id } });
+        }
+
+        // Pays a batch of requests in one pass. VOTE is minted per recipient through telos decide.
+        // Other tokens are grouped by token contract and symbol: each group is issued once, then
+        // fanned out with one transfer per request.
+        void makepayments (const vector<PaymentRequest>& requests) {
+
+            map<std::pair<name, symbol>, asset> issues;
+            vector<const PaymentRequest*> transfers;
+            for (const auto& request : requests) {
+                if (request.quantity.amount == 0) {
+                    continue;
+                }
+
+                if (request.quantity.symbol == common::S_VOTE) {
+                    action(
+                        permission_level{contract, "active"_n},
+                        config.get_name("telos_decide_contract"), "mint"_n,
+                        std::make_tuple(request.recipient, request.quantity, request.memo))
+                    .send();
+                } else {   // handles USD and REWARD
+                    auto key = std::make_pair (token_contract (), request.quantity.symbol);
+                    auto i_itr = issues.find (key);
+                    if (i_itr == issues.end()) {
+                        issues.emplace (key, request.quantity);
+                    } else {
+                        i_itr->second += request.quantity;
+                    }
+                    transfers.push_back (&request);
+                }
             }
 
-            debug ("Making payment to recipient: " + recipient.to_string() + ", quantity: " + quantity.to_string());
-    
-            config_table      config_s (contract, contract.value);
-   	        Config c = config_s.get_or_create (contract, Config());   
+            // issues are sent before transfers so that the contract holds the full amount
+            for (const auto& issue : issues) {
+                action(
+                    permission_level{contract, "active"_n},
+                    issue.first.first, "issue"_n,
+                    std::make_tuple(contract, issue.second, string { "Issue for DAO payments" }))
+                .send();
 
-            if (quantity.symbol == common::S_VOTE) {
+                LOG_DEBUG (logger, "Issue Token Event; ",
+                    "    Token Contract  : ", issue.first.first, "; ",
+                    "    Issue Amount    : ", issue.second, ".");
+            }
+
+            for (const auto* request : transfers) {
                 action(
                     permission_level{contract, "active"_n},
-                    c.names.at("telos_decide_contract"), "mint"_n,
-                    std::make_tuple(recipient, quantity, memo))
+                    token_contract (), "transfer"_n,
+                    std::make_tuple(contract, request->recipient, request->quantity, request->memo))
                 .send();
-            } else {   // handles USD and REWARD
-                // need to add steps in here about the deferments         
-                issuetoken (c.names.at("reward_token_contract"), recipient, quantity, memo );
-            } 
-           
-            payment_t.emplace (contract, [&](auto &p) {
-                p.payment_id    = payment_t.available_primary_key();
-                p.payment_date  = current_block_time().to_time_point();
-                p.period_id     = period_id;
-                p.assignment_id = assignment_id;
-                p.recipient     = recipient;
-                p.amount        = quantity;
-                p.memo          = memo;
-            });
+            }
+
+            uint64_t payment_id = next_payment_id();
+            if (!sequences.exists ("rollupfrom"_n)) {
+                // payments before this id were made before rollups existed; see compact_payments
+                sequences.set ("rollupfrom"_n, payment_id);
+            }
+            const time_point payment_date = current_block_time().to_time_point();
+            const uint64_t current_period = get_period_for (payment_date);
+            for (const auto& request : requests) {
+                if (request.quantity.amount == 0) {
+                    continue;
+                }
+
+                const uint64_t period_id = request.period_id == common::NO_PERIOD ? current_period : request.period_id;
+
+                LOG_DEBUG (logger, "Making payment to recipient: ", request.recipient, ", quantity: ", request.quantity);
+                payment_t.emplace (contract, [&](auto &p) {
+                    p.payment_id    = payment_id++;
+                    p.payment_date  = payment_date;
+                    p.period_id     = period_id;
+                    p.assignment_id = request.assignment_id;
+                    p.recipient     = request.recipient;
+                    p.amount        = request.quantity;
+                    p.memo          = request.memo;
+                });
+
+                add_to_rollup (request.recipient, period_id, request.quantity);
+                add_to_rollup (name(), period_id, request.quantity);
+            }
+            sequences.set ("paymentids"_n, payment_id);
         }
 
-        void addperiod (const time_point& start_date, const time_point& end_date) {
+        // Payment ids come from the paymentids sequence and are never reused: compaction empties
+        // the payments table, and ids from available_primary_key would fall below rollupfrom and
+        // behind the archive's last_payment_id. The sequence starts after every id used so far.
+        uint64_t next_payment_id () {
+            if (sequences.exists ("paymentids"_n)) {
+                return sequences.current ("paymentids"_n);
+            }
 
-            period_t.emplace (contract, [&](auto &p) {
-                p.period_id     = period_t.available_primary_key();
-                p.start_date    = start_date;
-                p.end_date      = end_date;
-            });
+            uint64_t payment_id = payment_t.available_primary_key();
+            payment_archive_table archive_s (contract, contract.value);
+            if (archive_s.exists() && archive_s.get().compacted_count > 0) {
+                payment_id = std::max (payment_id, archive_s.get().last_payment_id + 1);
+            }
+            if (sequences.exists ("rollupfrom"_n)) {
+                payment_id = std::max (payment_id, sequences.current ("rollupfrom"_n));
+            }
+            return payment_id;
         }
 
-        void issuetoken(const name& token_contract,
-                        const name& to,
-                        const asset& token_amount,
-                        const string& memo)
-        {
-            string debug_str = "";
-            debug_str = debug_str + "Issue Token Event; ";
-            debug_str = debug_str + "    Token Contract  : " + token_contract.to_string() + "; ";
-            debug_str = debug_str + "    Issue To        : " + to.to_string() + "; ";
-            debug_str = debug_str + "    Issue Amount    : " + token_amount.to_string() + ";";
-            debug_str = debug_str + "    Memo            : " + memo + ".";
+        // Folds payments older than payment_retention_periods (config int) into the rollup table
+        // and erases them, at most max_rows per call. Returns true when nothing old is left.
+        bool compact_payments (const uint64_t& max_rows) {
+            require_auth (contract);
+
+            uint64_t retention = config.get_int ("payment_retention_periods");
+            time_point cutoff;
+            if (!retention_cutoff (retention, cutoff)) {
+                return true;
+            }
+
+            // payments from rollupfrom on were added to the rollups when they were made
+            uint64_t rollup_from = sequences.exists ("rollupfrom"_n) ? sequences.current ("rollupfrom"_n) : payment_t.available_primary_key();
+
+            payment_archive_table archive_s (contract, contract.value);
+            PaymentArchive archive = archive_s.get_or_default (PaymentArchive());
+
+            uint64_t count = 0;
+            auto p_itr = payment_t.begin();
+            while (p_itr != payment_t.end() && p_itr->payment_date < cutoff && count < max_rows) {
+                if (p_itr->payment_id < rollup_from) {
+                    add_to_rollup (p_itr->recipient, p_itr->period_id, p_itr->amount);
+                    add_to_rollup (name(), p_itr->period_id, p_itr->amount);
+                }
+
+                auto previous = archive.digest.extract_as_byte_array();
+                vector<char> buffer (previous.begin(), previous.end());
+                vector<char> packed = pack (*p_itr);
+                buffer.insert (buffer.end(), packed.begin(), packed.end());
+                archive.digest = sha256 (buffer.data(), buffer.size());
+
+                archive.compacted_count++;
+                archive.last_payment_id = p_itr->payment_id;
+                p_itr = payment_t.erase (p_itr);
+                count++;
+            }
+
+            if (count > 0) {
+                archive.updated_date = current_time_point();
+                archive_s.set (archive, contract);
+            }
+
+            LOG_INFO (logger, "Compacted payments: ", count);
+            return p_itr == payment_t.end() || p_itr->payment_date >= cutoff;
+        }
+
+        // start of the period that lies retention periods before the current one
+        bool retention_cutoff (const uint64_t& retention, time_point& cutoff) {
+            uint64_t current_period = get_period_for (current_time_point());
+            if (current_period == common::NO_PERIOD || current_period < retention) {
+                return false;
+            }
+
+            Period period;
+            if (!get_period (current_period - retention, period)) {
+                return false;
+            }
+            cutoff = period.start_date;
+            return true;
+        }
+
+        // Replaces the calendar; a count of zero removes it, leaving only the stored periods.
+        void setcalendar (const time_point& epoch, const uint64_t& length_sec, 
+                            const uint64_t& count, const uint64_t& first_period_id) {
+            require_auth (contract);
+            calendar_table calendar_s (contract, contract.value);
+            if (count == 0) {
+                calendar_s.remove();
+                return;
+            }
+
+            check (length_sec > 0, errors::CALENDAR_LENGTH);
+            check (count <= common::NO_PERIOD - first_period_id, errors::CALENDAR_IDS);
+            check (count <= (std::numeric_limits<uint32_t>::max() - epoch.sec_since_epoch()) / length_sec, errors::CALENDAR_END);
+
+            // stored rows with ids inside the current calendar are overrides and stay so; any other
+            // stored id in the new range would silently become one
+            const uint64_t end_period_id = first_period_id + count;
+            uint64_t old_begin = end_period_id, old_end = end_period_id;
+            PeriodCalendar current;
+            if (get_calendar (current)) {
+                old_begin = std::max (first_period_id, std::min (current.first_period_id, end_period_id));
+                old_end = std::max (old_begin, std::min (current.first_period_id + current.count, end_period_id));
+            }
+            check (!has_period_in (first_period_id, old_begin) && !has_period_in (old_end, end_period_id), 
+                errors::CALENDAR_IDS_STORED, first_period_id, end_period_id - 1);
 
-            action(
-                permission_level{contract, "active"_n},
-                token_contract, "issue"_n,
-                std::make_tuple(contract, token_amount, memo))
-            .send();
+            calendar_s.set (PeriodCalendar { epoch, length_sec, count, first_period_id }, contract);
+        }
 
-            action(
-                permission_level{contract, "active"_n},
-                token_contract, "transfer"_n,
-                std::make_tuple(contract, to, token_amount, memo))
-            .send();
+        bool get_calendar (PeriodCalendar& calendar) {
+            calendar_table calendar_s (contract, contract.value);
+            if (!calendar_s.exists()) {
+                return false;
+            }
+            calendar = calendar_s.get();
+            return true;
+        }
 
-            debug (debug_str);
+        static bool in_calendar (const PeriodCalendar& calendar, const uint64_t& period_id) {
+            return period_id >= calendar.first_period_id && period_id - calendar.first_period_id < calendar.count;
+        }
+
+        // true if a stored period has an id in [begin_period_id, end_period_id)
+        bool has_period_in (const uint64_t& begin_period_id, const uint64_t& end_period_id) {
+            auto p_itr = period_t.lower_bound (begin_period_id);
+            return p_itr != period_t.end() && p_itr->period_id < end_period_id;
+        }
+
+        // Stored row if there is one, otherwise the calendar period with that id.
+        bool get_period (const uint64_t& period_id, Period& period) {
+            auto p_itr = period_t.find (period_id);
+            if (p_itr != period_t.end()) {
+                period = *p_itr;
+                return true;
+            }
+
+            PeriodCalendar calendar;
+            if (!get_calendar (calendar) || !in_calendar (calendar, period_id)) {
+                return false;
+            }
+
+            const uint64_t start_sec = calendar.epoch.sec_since_epoch() + (period_id - calendar.first_period_id) * calendar.length_sec;
+            period.period_id     = period_id;
+            period.start_date    = time_point_sec (start_sec);
+            period.end_date      = time_point_sec (start_sec + calendar.length_sec - 1);
+            return true;
+        }
+
+        // Period containing time; returns NO_PERIOD if there is none. Stored rows are checked
+        // first (O(log n) on byenddate), then the calendar in O(1).
+        uint64_t get_period_for (const time_point& time) {
+            check (periods_migrated(), errors::PERIODS_NOT_MIGRATED);
+            const uint64_t seconds = time.sec_since_epoch();
+            auto end_index = period_t.get_index<"byenddate"_n>();
+            auto p_itr = end_index.lower_bound (seconds);
+            if (p_itr != end_index.end() && p_itr->start_date.sec_since_epoch() <= seconds) {
+                return p_itr->period_id;
+            }
+
+            PeriodCalendar calendar;
+            if (!get_calendar (calendar)) {
+                return common::NO_PERIOD;
+            }
+            const uint64_t epoch_sec = calendar.epoch.sec_since_epoch();
+            if (seconds < epoch_sec) {
+                return common::NO_PERIOD;
+            }
+
+            const uint64_t index = (seconds - epoch_sec) / calendar.length_sec;
+            if (index >= calendar.count) {
+                return common::NO_PERIOD;
+            }
+            // an override of this calendar period would have matched above if it contained time
+            const uint64_t period_id = calendar.first_period_id + index;
+            return period_t.find (period_id) == period_t.end() ? period_id : common::NO_PERIOD;
+        }
+
+        // Re-emplaces up to max_rows period rows so they get entries in the secondary indexes.
+        // Returns true when all rows have been migrated.
+        // The migration runs once: when it is done the periodmig cursor is set to NO_PERIOD and
+        // migperiods refuses to run again. Rows written since the indexes were added already have
+        // their index entries and are skipped; erasing them through the index-less view would
+        // orphan those entries.
+        bool migrate_periods (const uint64_t& max_rows) {
+            require_auth (contract);
+            check (!periods_migrated(), errors::PERIODS_MIGRATED);
+
+            if (!sequences.exists ("periodmig"_n)) {
+                sequences.set ("periodmig"_n, 0);
+            }
+            uint64_t next_id = sequences.current ("periodmig"_n);
+
+            legacy_period_table legacy_t (contract, contract.value);
+            uint64_t count = 0;
+            auto l_itr = legacy_t.lower_bound (next_id);
+            while (l_itr != legacy_t.end() && count < max_rows) {
+                Period period = *l_itr;
+                next_id = period.period_id + 1;
+                count++;
+                if (has_index_entries (period)) {
+                    l_itr++;
+                    continue;
+                }
+
+                l_itr = legacy_t.erase (l_itr);
+                period_t.emplace (contract, [&](auto &p) {
+                    p = period;
+                });
+            }
+
+            const bool done = l_itr == legacy_t.end();
+            sequences.set ("periodmig"_n, done ? common::NO_PERIOD : next_id);
+            return done;
+        }
+
+        // True once migrate_periods has finished, or when there has never been a period to migrate.
+        bool periods_migrated () {
+            if (sequences.exists ("periodmig"_n)) {
+                return sequences.current ("periodmig"_n) == common::NO_PERIOD;
+            }
+            legacy_period_table legacy_t (contract, contract.value);
+            return legacy_t.begin() == legacy_t.end();
+        }
+
+        // Writers call this before adding rows; on a contract with no periods yet it records the
+        // migration as done, since every row from now on is written with its index entries.
+        void require_periods_migrated () {
+            check (periods_migrated(), errors::PERIODS_NOT_MIGRATED);
+            if (!sequences.exists ("periodmig"_n)) {
+                sequences.set ("periodmig"_n, common::NO_PERIOD);
+            }
+        }
+
+        bool has_index_entries (const Period& period) {
+            auto end_index = period_t.get_index<"byenddate"_n>();
+            for (auto p_itr = end_index.lower_bound (period.by_end()); 
+                    p_itr != end_index.end() && p_itr->by_end() == period.by_end(); ++p_itr) {
+                if (p_itr->period_id == period.period_id) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void add_to_rollup (const name& recipient, const uint64_t& period_id, const asset& quantity) {
+            rollup_table r_t (contract, quantity.symbol.code().raw());
+            auto r_index = r_t.get_index<"byrecperiod"_n>();
+            auto r_itr = r_index.find (rollup_key (recipient, period_id));
+
+            if (r_itr == r_index.end()) {
+                r_t.emplace (contract, [&](auto &r) {
+                    r.rollup_id     = r_t.available_primary_key();
+                    r.recipient     = recipient;
+                    r.period_id     = period_id;
+                    r.amount        = quantity;
+                    r.payment_count = 1;
+                });
+            } else {
+                r_index.modify (r_itr, contract, [&](auto &r) {
+                    r.amount        += quantity;
+                    r.payment_count++;
+                    r.updated_date  = current_time_point();
+                });
+            }
+        }
+
+        // all non-VOTE tokens (REWARD, USD) are issued by the reward token contract
+        name token_contract () {
+            return config.get_name("reward_token_contract");
+        }
+
+        void addperiod (const time_point& start_date, const time_point& end_date) {
+            addperiods ({ std::make_pair (start_date, end_date) });
+        }
+
+        // Stores the periods with consecutive ids after the last stored period. The batch must be
+        // in time order, and no period may overlap another one in the batch or in the table.
+        void addperiods (const vector<std::pair<time_point, time_point>>& periods) {
+            require_periods_migrated();
+            auto end_index = period_t.get_index<"byenddate"_n>();
+            for (size_t i = 0; i < periods.size(); i++) {
+                const auto& [start_date, end_date] = periods[i];
+                check (start_date < end_date, errors::PERIOD_DATES, i);
+                if (i > 0) {
+                    check (periods[i - 1].second < start_date, errors::PERIOD_ORDER, i);
+                }
+
+                // first stored period that ends at or after this one starts
+                auto p_itr = end_index.lower_bound (start_date.sec_since_epoch());
+                if (p_itr != end_index.end()) {
+                    check (p_itr->start_date > end_date, errors::PERIOD_OVERLAP, p_itr->period_id);
+                }
+            }
+
+            uint64_t period_id = period_t.available_primary_key();
+            PeriodCalendar calendar;
+            if (get_calendar (calendar)) {
+                const uint64_t calendar_start = calendar.epoch.sec_since_epoch();
+                const uint64_t calendar_end = calendar_start + calendar.count * calendar.length_sec;
+                for (size_t i = 0; i < periods.size(); i++) {
+                    check (periods[i].second.sec_since_epoch() < calendar_start || periods[i].first.sec_since_epoch() >= calendar_end, 
+                        errors::PERIOD_IN_CALENDAR, i);
+                }
+                // keep the new ids clear of the calendar's so they never read as overrides
+                if (period_id < calendar.first_period_id + calendar.count && period_id + periods.size() > calendar.first_period_id) {
+                    period_id = calendar.first_period_id + calendar.count;
+                }
+            }
+            for (const auto& [start_date, end_date] : periods) {
+                period_t.emplace (contract, [&](auto &p) {
+                    p.period_id     = period_id++;
+                    p.start_date    = start_date;
+                    p.end_date      = end_date;
+                });
+            }
+        }
+
+        // Stores (or replaces) the override of calendar period period_id. It may not overlap any
+        // other stored period; times it leaves uncovered belong to no period.
+        void overperiod (const uint64_t& period_id, const time_point& start_date, const time_point& end_date) {
+            require_periods_migrated();
+            PeriodCalendar calendar;
+            check (get_calendar (calendar) && in_calendar (calendar, period_id), errors::NOT_CALENDAR_PERIOD, period_id);
+            check (start_date < end_date, errors::PERIOD_DATES, period_id);
+
+            auto end_index = period_t.get_index<"byenddate"_n>();
+            for (auto p_itr = end_index.lower_bound (start_date.sec_since_epoch()); 
+                    p_itr != end_index.end() && p_itr->start_date <= end_date; ++p_itr) {
+                check (p_itr->period_id == period_id, errors::PERIOD_OVERLAP, p_itr->period_id);
+            }
+
+            auto p_itr = period_t.find (period_id);
+            if (p_itr == period_t.end()) {
+                period_t.emplace (contract, [&](auto &p) {
+                    p.period_id     = period_id;
+                    p.start_date    = start_date;
+                    p.end_date      = end_date;
+                });
+            } else {
+                period_t.modify (p_itr, contract, [&](auto &p) {
+                    p.start_date    = start_date;
+                    p.end_date      = end_date;
+                });
+            }
         }
 
         bool holds_hypha (const name& account) 
         {
-            config_table      config_s (contract, contract.value);
-   	        Config c = config_s.get_or_create (contract, Config());   
-
-            eosiotoken::accounts a_t (c.names.at("reward_token_contract"), account.value);
+            eosiotoken::accounts a_t (config.get_name("reward_token_contract"), account.value);
             auto a_itr = a_t.find (common::S_REWARD.code().raw());
             if (a_itr == a_t.end()) {
                 return false;
@@ -1,7 +1,13 @@
 #pragma once
 
+#include <limits>
+
+#include <eosio/eosio.hpp>
+#include <eosio/asset.hpp>
 #include <eosio/symbol.hpp>
 
+#include "errors.hpp"
+
 using namespace eosio;
 using std::string;
 
@@ -12,10 +18,39 @@ namespace common {
     static const symbol         S_USD                           ("USD", 2);
    
     static const uint64_t       NO_ASSIGNMENT                   = -1;         
+    static const uint64_t       NO_PERIOD                       = -1;
 
     static const uint64_t       MICROSECONDS_PER_HOUR   = (uint64_t)60 * (uint64_t)60 * (uint64_t)1000000;
     static const uint64_t       MICROSECONDS_PER_YEAR   = MICROSECONDS_PER_HOUR * (uint64_t)24 * (uint64_t)365;
 
-    static const float          WEEK_TO_YEAR_RATIO     = (float) ((float)52 / (float)365.25);
+    // 52 / 365.25 as an exact ratio; apply it with prorate (amount, WEEK_TO_YEAR_NUMERATOR, WEEK_TO_YEAR_DENOMINATOR)
+    static constexpr uint64_t   WEEK_TO_YEAR_NUMERATOR  = 5200;
+    static constexpr uint64_t   WEEK_TO_YEAR_DENOMINATOR = 36525;
+
+    // ratios expressed in basis points: 10000 is 100%
+    static constexpr uint64_t   BASIS_POINTS            = 10000;
+
+    // Fixed-point helpers. Amounts stay in the asset's smallest unit; the product is taken in
+    // 128 bits, so value * numerator cannot overflow, and the quotient is truncated toward zero.
+    // Fails if denominator is zero or the result does not fit in int64_t.
+    constexpr int64_t muldiv (const int64_t& value, const uint64_t& numerator, const uint64_t& denominator) {
+        if (denominator == 0) {
+            errors::fail (errors::MULDIV_ZERO_DENOMINATOR);
+        }
+        const __int128 result = static_cast<__int128> (value) * numerator / denominator;
+        if (result < std::numeric_limits<int64_t>::min() || result > std::numeric_limits<int64_t>::max()) {
+            errors::fail (errors::MULDIV_OVERFLOW, numerator, denominator);
+        }
+        return static_cast<int64_t> (result);
+    }
+
+    // amount * part / whole, e.g. a salary prorated over the part of a period worked
+    inline asset prorate (const asset& amount, const uint64_t& part, const uint64_t& whole) {
+        return asset { muldiv (amount.amount, part, whole), amount.symbol };
+    }
 
+    // amount * bps / 10000
+    inline asset apply_bps (const asset& amount, const uint64_t& bps) {
+        return prorate (amount, bps, BASIS_POINTS);
+    }
 };
\ No newline at end of file
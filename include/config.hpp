@@ -0,0 +1,111 @@
+#ifndef CONFIG_H
+#define CONFIG_H
+
+#include <eosio/eosio.hpp>
+#include <eosio/asset.hpp>
+#include <eosio/singleton.hpp>
+#include <eosio/transaction.hpp>
+
+#include "errors.hpp"
+
+using namespace eosio;
+using std::string;
+using std::map;
+
+struct [[eosio::table, eosio::contract("dao") ]] Config
+{
+   // required configurations:
+   // names : telos_decide_contract, reward_token_contract
+   // (last_ballot_id and last_sender_id are accepted by setconfig but stored in the sequences table)
+   // ints  : voting_duration_sec, paused
+   // optional ints: quorum_bps, share of the VOTE supply in basis points that must vote (default 2000)
+   //                native_tally, 1 to vote on new proposals with dao::vote instead of telos decide (default 0)
+   //                (requires the decide VOTE treasury to be non-transferable; see dao::vote)
+   map<string, name>          names             ;
+   map<string, string>        strings           ;
+   map<string, asset>         assets            ;
+   map<string, time_point>    time_points       ;
+   map<string, uint64_t>      ints              ;
+   map<string, transaction>   trxs              ;
+   map<string, float>         floats            ;
+};
+
+typedef singleton<"config"_n, Config> config_table;
+
+// ConfigContext is shared by the dao contract and the Bank for the duration of one action.
+// The singleton is deserialized on first use only, and it is written back once, when the
+// context goes out of scope, and only if a caller asked for a mutable copy via modify().
+class ConfigContext {
+
+   public:
+
+      ConfigContext (const name& contract):
+         contract (contract),
+         config_s (contract, contract.value) {}
+
+      ConfigContext (const ConfigContext&) = delete;
+      ConfigContext& operator= (const ConfigContext&) = delete;
+
+      ~ConfigContext () { flush(); }
+
+      const Config& get () {
+         if (!loaded) {
+            c = config_s.get_or_create (contract, Config());
+            loaded = true;
+         }
+         return c;
+      }
+
+      Config& modify () {
+         get();
+         dirty = true;
+         return c;
+      }
+
+      void flush () {
+         if (dirty) {
+            config_s.set (c, contract);
+            dirty = false;
+         }
+      }
+
+      name get_name (const string& key) {
+         const Config& cfg = get();
+         auto itr = cfg.names.find (key);
+         check (itr != cfg.names.end(), errors::NAME_CONFIG_MISSING, key);
+         return itr->second;
+      }
+
+      uint64_t get_int (const string& key) {
+         const Config& cfg = get();
+         auto itr = cfg.ints.find (key);
+         check (itr != cfg.ints.end(), errors::INT_CONFIG_MISSING, key);
+         return itr->second;
+      }
+
+      uint64_t get_int (const string& key, const uint64_t& default_value) {
+         const Config& cfg = get();
+         auto itr = cfg.ints.find (key);
+         return itr == cfg.ints.end() ? default_value : itr->second;
+      }
+
+      bool has_int (const string& key) {
+         const Config& cfg = get();
+         return cfg.ints.find (key) != cfg.ints.end();
+      }
+
+      string get_string (const string& key) {
+         const Config& cfg = get();
+         auto itr = cfg.strings.find (key);
+         return itr == cfg.strings.end() ? string {""} : itr->second;
+      }
+
+   private:
+      name           contract;
+      config_table   config_s;
+      Config         c;
+      bool           loaded   = false;
+      bool           dirty    = false;
+};
+
+#endif
@@ -1,6 +1,8 @@
 #ifndef dao_H
 #define dao_H
 
+#include <set>
+
 #include <eosio/eosio.hpp>
 #include <eosio/asset.hpp>
 #include <eosio/singleton.hpp>
@@ -9,7 +11,12 @@
 
 #include "bank.hpp"
 #include "common.hpp"
+#include "config.hpp"
 #include "decide.hpp"
+#include "eraser.hpp"
+#include "errors.hpp"
+#include "logger.hpp"
+#include "sequence.hpp"
 
 using namespace eosio;
 using std::string;
@@ -18,32 +25,50 @@ CONTRACT dao : public contract {
    public:
       using contract::contract;
 
-      struct [[eosio::table, eosio::contract("dao") ]] Config 
-      {
-         // required configurations:
-         // names : telos_decide_contract, reward_token_contract, vote_token_contract, last_ballot_id
-         // ints  : voting_duration_sec
-         map<string, name>          names             ;
-         map<string, string>        strings           ;
-         map<string, asset>         assets            ;
-         map<string, time_point>    time_points       ;
-         map<string, uint64_t>      ints              ;
-         map<string, transaction>   trxs              ;
-         map<string, float>         floats            ;
-      };
-
-      typedef singleton<"config"_n, Config> config_table;
       typedef multi_index<"config"_n, Config> config_table_placeholder;
 
       struct [[eosio::table, eosio::contract("dao") ]] Member 
       {
          name              member                  ;
-         vector<uint64_t>  completed_challenges    ;
+         vector<uint64_t>  completed_challenges    ;     // legacy; moved to the completions table when the member completes a challenge
          uint64_t          primary_key() const { return member.value; }
       };
 
       typedef multi_index<"members"_n, Member> member_table;
 
+      // one row per (member, challenge) completion
+      struct [[eosio::table, eosio::contract("dao") ]] Completion
+      {
+         uint64_t          completion_id           ;
+         name              member                  ;
+         uint64_t          challenge_id            ;
+         time_point        completed_date          = current_time_point();
+
+         uint64_t          primary_key()              const { return completion_id; }
+         uint128_t         by_member_challenge()      const { return completion_key (member, challenge_id); }
+         uint64_t          by_challenge()             const { return challenge_id; }
+      };
+
+      static uint128_t completion_key (const name& member, const uint64_t& challenge_id) {
+         return (uint128_t { member.value } << 64) | challenge_id;
+      }
+
+      typedef multi_index<"completions"_n, Completion,
+         indexed_by<"bymemchlg"_n, const_mem_fun<Completion, uint128_t, &Completion::by_member_challenge>>,
+         indexed_by<"bychallenge"_n, const_mem_fun<Completion, uint64_t, &Completion::by_challenge>>
+      > completion_table;
+
+      // number of members who completed each challenge
+      struct [[eosio::table, eosio::contract("dao") ]] ChallengeCount
+      {
+         uint64_t          challenge_id            ;
+         uint64_t          completions             = 0;
+
+         uint64_t          primary_key()              const { return challenge_id; }
+      };
+
+      typedef multi_index<"chlgcounts"_n, ChallengeCount> challenge_count_table;
+
       struct [[eosio::table, eosio::contract("dao") ]] Applicant 
       {
          name           applicant                  ;
@@ -56,8 +81,193 @@ CONTRACT dao : public contract {
       };
       typedef multi_index<"applicants"_n, Applicant> applicant_table;
 
-      // scope: proposal, member, applicant, challenge
+      // aggregate counts kept up to date by addmember, removemember, apply, enroll and remapply
+      struct [[eosio::table, eosio::contract("dao") ]] Stats
+      {
+         uint64_t       members                    = 0;
+         uint64_t       applicants                 = 0;
+         time_point     updated_date               = current_time_point();
+      };
+
+      typedef singleton<"stats"_n, Stats> stats_table;
+      typedef multi_index<"stats"_n, Stats> stats_table_placeholder;
+
+      // progress of a recount that did not finish within one action; removed when done
+      struct [[eosio::table, eosio::contract("dao") ]] Recount
+      {
+         name           list                       ;     // members or applicants
+         uint64_t       next_key                   = 0;
+         uint64_t       members                    = 0;
+         uint64_t       applicants                 = 0;
+      };
+
+      typedef singleton<"recount"_n, Recount> recount_table;
+      typedef multi_index<"recount"_n, Recount> recount_table_placeholder;
+
+      // scope: proposal, role, assignment, challenge, ...
+      // Object is the fixed-size header of an object; it is all that lifecycle actions and
+      // index scans need. Long strings, transactions and ad-hoc fields live in ObjectBody,
+      // stored in the same scope under the same id.
+      // Proposals keep their id for life and move through status: open -> passed | failed -> archived.
       struct [[eosio::table, eosio::contract("dao") ]] Object
+      {
+         uint64_t                   id                ;
+
+         name                       owner             ;
+         name                       type              ;
+         name                       ballot_id         ;
+         name                       status            ;
+         uint64_t                   fk                = 0;
+         // proposals: trx_action_contract::trx_action_name (id) runs when the proposal passes; both
+         // are empty on migrated proposals that carry an exec_on_approval transaction in the body
+         name                       trx_action_contract  ;
+         name                       trx_action_name      ;
+         uint64_t                   primary_key()     const { return id; }
+
+         // indexes
+         uint64_t                   by_owner()        const { return owner.value; }
+         uint64_t                   by_type ()        const { return type.value; }
+         uint64_t                   by_fk()           const { return fk; }
+         uint64_t                   by_status()       const { return status.value; }
+       
+         // timestamps
+         time_point                 created_date    = current_time_point();
+         time_point                 updated_date    = current_time_point();
+         uint64_t    by_created () const { return created_date.sec_since_epoch(); }
+         uint64_t    by_updated () const { return updated_date.sec_since_epoch(); }
+      };
+
+      typedef multi_index<"objectsv2"_n, Object,
+         indexed_by<"bycreated"_n, const_mem_fun<Object, uint64_t, &Object::by_created>>, // index 2
+         indexed_by<"byupdated"_n, const_mem_fun<Object, uint64_t, &Object::by_updated>>, // 3
+         indexed_by<"byowner"_n, const_mem_fun<Object, uint64_t, &Object::by_owner>>, // 4
+         indexed_by<"bytype"_n, const_mem_fun<Object, uint64_t, &Object::by_type>>, // 5
+         indexed_by<"byfk"_n, const_mem_fun<Object, uint64_t, &Object::by_fk>>, // 6
+         indexed_by<"bystatus"_n, const_mem_fun<Object, uint64_t, &Object::by_status>> // 7
+      > object_table;
+
+      // Well-known fields are fixed members; anything else submitted with an object
+      // lands in the string-keyed extension maps.
+      struct [[eosio::table, eosio::contract("dao") ]] ObjectBody
+      {
+         uint64_t                   id                ;
+
+         string                     title             ;
+         string                     description       ;
+         string                     content           ;
+
+         // extension maps
+         map<string, name>          names             ;
+         map<string, string>        strings           ;
+         map<string, asset>         assets            ;
+         map<string, time_point>    time_points       ;
+         map<string, uint64_t>      ints              ;
+         map<string, transaction>   trxs              ;
+         map<string, float>         floats            ;
+         uint64_t                   primary_key()     const { return id; }
+      };
+
+      typedef multi_index<"objbodies"_n, ObjectBody> object_body_table;
+
+      // compacted headers of closed proposals; the bodies are dropped (ballot details remain in telos decide)
+      struct [[eosio::table, eosio::contract("dao") ]] ArchivedProposal
+      {
+         uint64_t                   id                ;
+         name                       owner             ;
+         name                       type              ;
+         name                       ballot_id         ;
+         name                       status            ;
+         time_point                 created_date      ;
+         time_point                 closed_date       ;
+
+         uint64_t                   primary_key()     const { return id; }
+         uint64_t                   by_owner()        const { return owner.value; }
+      };
+
+      typedef multi_index<"proparchive"_n, ArchivedProposal,
+         indexed_by<"byowner"_n, const_mem_fun<ArchivedProposal, uint64_t, &ArchivedProposal::by_owner>>
+      > archive_table;
+
+      // Expiry queue: one row per open proposal, ordered by the time its ballot closes.
+      // It also keeps the quorum threshold computed from the VOTE supply when voting opened.
+      // Rows are added by create and removed when the proposal is closed; crank pops the due
+      // ones, and closeprops maps expired decide ballots back to proposals through byballot.
+      struct [[eosio::table, eosio::contract("dao") ]] Expiry
+      {
+         uint64_t                   proposal_id       ;
+         name                       ballot_id         ;
+         time_point_sec             expiration        ;
+         asset                      quorum_threshold  ;     // snapshot taken when voting opened
+
+         uint64_t                   primary_key()     const { return proposal_id; }
+         uint64_t                   by_expiration()   const { return expiration.sec_since_epoch(); }
+         uint64_t                   by_ballot()       const { return ballot_id.value; }
+      };
+
+      typedef multi_index<"expiries"_n, Expiry,
+         indexed_by<"byexpiration"_n, const_mem_fun<Expiry, uint64_t, &Expiry::by_expiration>>,
+         indexed_by<"byballot"_n, const_mem_fun<Expiry, uint64_t, &Expiry::by_ballot>>
+      > expiry_table;
+
+      // Passed proposals closed by crank or closeprops whose action has not run yet; execprop
+      // runs it and removes the row. Batch closes only record it here, so one proposal whose
+      // action fails cannot undo the close of the others in the batch.
+      struct [[eosio::table, eosio::contract("dao") ]] PendingExec
+      {
+         uint64_t                   proposal_id       ;
+         time_point                 passed_date       = current_time_point();
+
+         uint64_t                   primary_key()     const { return proposal_id; }
+      };
+
+      typedef multi_index<"pendingexecs"_n, PendingExec> pending_exec_table;
+
+      // Running pass/fail tally of a proposal voted on natively (config int native_tally = 1)
+      // instead of through telos decide; updated by every vote, so closing needs no scan.
+      // Decide ballots are read into the same shape when they are closed. The row is erased
+      // with its proposal (eraseobj, eraseobjs, archiveprops compact); proposal ids are never
+      // reused, so a row left behind cannot be taken over by a later proposal either.
+      struct [[eosio::table, eosio::contract("dao") ]] Tally
+      {
+         uint64_t                   proposal_id       ;
+         asset                      votes_pass        ;
+         asset                      votes_fail        ;
+         asset                      total_weight      ;
+         uint64_t                   voters            = 0;
+
+         uint64_t                   primary_key()     const { return proposal_id; }
+      };
+
+      typedef multi_index<"tallies"_n, Tally> tally_table;
+
+      // scope: proposal_id; the vote each account cast on a natively tallied proposal. Voters
+      // pay for the rows; clrreceipts frees them once the proposal's tally is gone.
+      struct [[eosio::table, eosio::contract("dao") ]] VoteReceipt
+      {
+         name                       voter             ;
+         name                       option            ;     // pass or fail
+         asset                      weight            ;     // liquid VOTE balance when the vote was cast
+         time_point                 vote_time         = current_time_point();
+
+         uint64_t                   primary_key()     const { return voter.value; }
+      };
+
+      typedef multi_index<"receipts"_n, VoteReceipt> receipt_table;
+
+      // ballots already created in telos decide and left in setup state; create claims the
+      // first one, so a new proposal only has to edit and open its ballot
+      struct [[eosio::table, eosio::contract("dao") ]] PooledBallot
+      {
+         name                       ballot_id         ;
+         time_point                 created_date      = current_time_point();
+
+         uint64_t                   primary_key()     const { return ballot_id.value; }
+      };
+
+      typedef multi_index<"ballotpool"_n, PooledBallot> ballot_pool_table;
+
+      // original map-only layout; rows are moved to objectsv2 by migrateobjs
+      struct [[eosio::table, eosio::contract("dao") ]] LegacyObject
       {
          uint64_t                   id                ;
          
@@ -83,14 +293,15 @@ CONTRACT dao : public contract {
          uint64_t    by_updated () const { return updated_date.sec_since_epoch(); }
       };
 
-      typedef multi_index<"objects"_n, Object,
-         indexed_by<"bycreated"_n, const_mem_fun<Object, uint64_t, &Object::by_created>>, // index 2
-         indexed_by<"byupdated"_n, const_mem_fun<Object, uint64_t, &Object::by_updated>>, // 3
-         indexed_by<"byowner"_n, const_mem_fun<Object, uint64_t, &Object::by_owner>>, // 4
-         indexed_by<"bytype"_n, const_mem_fun<Object, uint64_t, &Object::by_type>>, // 5
-         indexed_by<"byfk"_n, const_mem_fun<Object, uint64_t, &Object::by_fk>> // 6
-      > object_table;
+      typedef multi_index<"objects"_n, LegacyObject,
+         indexed_by<"bycreated"_n, const_mem_fun<LegacyObject, uint64_t, &LegacyObject::by_created>>, // index 2
+         indexed_by<"byupdated"_n, const_mem_fun<LegacyObject, uint64_t, &LegacyObject::by_updated>>, // 3
+         indexed_by<"byowner"_n, const_mem_fun<LegacyObject, uint64_t, &LegacyObject::by_owner>>, // 4
+         indexed_by<"bytype"_n, const_mem_fun<LegacyObject, uint64_t, &LegacyObject::by_type>>, // 5
+         indexed_by<"byfk"_n, const_mem_fun<LegacyObject, uint64_t, &LegacyObject::by_fk>> // 6
+      > legacy_object_table;
 
+      // superseded by the debuglog ring buffer (see logger.hpp); clrdebugs erases the remaining rows
       struct [[eosio::table, eosio::contract("dao") ]] Debug
       {
          uint64_t    debug_id;
@@ -116,12 +327,29 @@ CONTRACT dao : public contract {
                      const name& applicant, 
 					      const string& content);
 
+      // enrolls every applicant in one action; fails without changes if any is not enrollable
+      ACTION enrollmany (const name& enroller,
+                         const vector<name>& applicants,
+                         const string& content);
+
       // Admin
-      ACTION reset ();
-      ACTION resetperiods();
-      ACTION eraseobjs (const name& scope);
+      // bulk erases remove at most batch_size rows per call and reschedule themselves until done
+      ACTION reset (const uint64_t& batch_size);
+      ACTION resetperiods (const uint64_t& batch_size);
+      ACTION compactpays (const uint64_t& batch_size);
+      ACTION eraseobjs (const name& scope, const uint64_t& batch_size);
       ACTION eraseobj (const name& scope,
                         const uint64_t&   id);
+      // moves legacy rows into objectsv2/objbodies; legacy proposals without a status take it from
+      // their decide ballot
+      ACTION migrateobjs (const name& scope, const uint64_t& batch_size);
+      // erases the vote receipts of an erased or compacted proposal, returning the RAM to the voters
+      ACTION clrreceipts (const uint64_t& proposal_id, const uint64_t& batch_size);
+      // rebuilds the stats counters from the members and applicants tables, batch_size rows per
+      // call; changes made while it runs are not counted, so pause the contract first
+      ACTION recount (const uint64_t& batch_size);
+      // creates count ballots in setup state and adds them to the ballot pool
+      ACTION fillpool (const uint64_t& count);
       ACTION togglepause ();
       ACTION debugmsg (const string& message);
       ACTION updversion (const string& component, const string& version);
@@ -136,12 +364,27 @@ CONTRACT dao : public contract {
 
       ACTION setlastballt (const name& last_ballot_id);
 
-      ACTION clrdebugs (const uint64_t& starting_id, const uint64_t& batch_size);
+      ACTION clrdebugs (const uint64_t& batch_size);
 
       ACTION addperiod (const time_point& start_time, 
                         const time_point& end_time);
+      // (start, end) pairs in time order; none may overlap each other or a stored period
+      ACTION addperiods (const vector<std::pair<time_point, time_point>>& periods);
+      // regular periods computed from epoch, length and count; count 0 removes the calendar
+      ACTION setcalendar (const time_point& epoch, const uint64_t& length_sec, 
+                          const uint64_t& count, const uint64_t& first_period_id);
+      // replaces calendar period period_id with the given dates
+      ACTION overperiod (const uint64_t& period_id, const time_point& start_date, const time_point& end_date);
+      // one-shot: adds index entries for periods stored before the indexes existed; period
+      // writes, removals and lookups by time fail until it has finished
+      ACTION migperiods (const uint64_t& batch_size);
+
+      // read-only: prints the period that contains time; nothing is written
+      ACTION getperiod (const time_point& time);
+
       ACTION remperiods (const uint64_t& begin_period_id, 
-                         const uint64_t& end_period_id);
+                         const uint64_t& end_period_id,
+                         const uint64_t& batch_size);
 
       ACTION remapply (const name& applicant);
 
@@ -150,110 +393,168 @@ CONTRACT dao : public contract {
       ACTION newrole    (  const uint64_t&   proposal_id);
       ACTION assign     (  const uint64_t& 	proposal_id);
       ACTION exectrx    (  const uint64_t&   proposal_id);
+      ACTION passprop   (  const uint64_t&   proposal_id);
 
-      ACTION compchalleng (const name& completer, const uint64_t& challenge_id) 
+      ACTION compchalleng (const name& completer, const uint64_t& challenge_id);
       
+      // casts or changes voter's vote on a natively tallied proposal; option is pass or fail
+      ACTION vote (const name& voter, const uint64_t& proposal_id, const name& option);
+
       // anyone can call closeprop, it executes the transaction if the voting passed
       ACTION closeprop(const uint64_t& proposal_id);
+
+      // anyone can call closeprops; it walks the telos decide ballots in end-time order from where
+      // the previous call stopped, examines at most max_count expired ballots and closes the
+      // proposals among them. Passed proposals are queued for execprop, not executed.
+      ACTION closeprops (const uint64_t& max_count);
+
+      // permissionless keeper action: closes the proposals whose ballots have expired, in
+      // expiration order, examining at most max_work queue entries; like closeprops, it leaves
+      // execution of the passed ones to execprop
+      ACTION crank (const uint64_t& max_work);
+
+      // anyone can call execprop; it runs the action of a proposal passed by crank or closeprops
+      ACTION execprop (const uint64_t& proposal_id);
+
+      // marks up to max_count passed/failed proposals as archived; with compact, moves them
+      // into the proparchive table and erases the proposal rows. Proposals still waiting for
+      // execprop are left alone.
+      ACTION archiveprops (const uint64_t& max_count, const bool& compact);
             
       // temporary hack (?) - keep a list of the members, although true membership is governed by token holdings
       ACTION removemember(const name& member_to_remove);
       ACTION addmember (const name& member);
+
+      // read-only: prints up to limit accounts from list (members or applicants), starting at
+      // lower_bound, with the totals and the cursor for the next page; nothing is written
+      ACTION getroster (const name& list, const name& lower_bound, const uint64_t& limit);
       
    private:
-      Bank bank = Bank (get_self());
+      // declaration order matters: config, sequences and logger are shared with bank
+      ConfigContext config = ConfigContext (get_self());
+      Sequences sequences = Sequences (get_self());
+      Logger logger = Logger (get_self(), config, sequences);
+      Bank bank = Bank (get_self(), config, sequences, logger);
+      BatchEraser eraser = BatchEraser (get_self());
 
       void defcloseprop (const uint64_t& proposal_id);
+      asset get_quorum_threshold ();
+      bool vote_transferable ();
+      Tally ballot_tally (const decidespace::decide::ballot& ballot);
+      void close_proposal (object_table& o_t, 
+                           object_table::const_iterator o_itr, 
+                           const Tally& tally,
+                           const asset& quorum_threshold,
+                           const bool& execute);
+      void execute_proposal (const Object& proposal);
+      name legacy_proposal_status (const decidespace::decide::ballots_table& ballot_t, const name& ballot_id);
       void qualify_proposer (const name& proposer);
+      void enroll_applicants (const vector<name>& applicants);
+      name new_ballot ();
       name register_ballot (const name& proposer, 
-								      const map<string, string>& strings);
+                            const string& title,
+                            const string& description,
+                            const string& content,
+                            const time_point_sec& expiration);
+      bool record_completion (const name& member, const uint64_t& challenge_id);
+      void adjust_stats (const int64_t& members, const int64_t& applicants);
+      uint64_t next_object_id (const name& scope);
+      void erase_object (const name& scope, const uint64_t& id);
+      void pack_object (Object& o,
+                        ObjectBody& body,
+                        map<string, name>          names,
+                        map<string, string>        strings,
+                        map<string, asset>         assets,
+                        map<string, time_point>    time_points,
+                        map<string, uint64_t>      ints,
+                        map<string, float>         floats,
+                        map<string, transaction>   trxs);
+
+      // removes key from the map and returns its value, or default_value if it is not present
+      template <typename T>
+      T take (map<string, T>& m, const string& key, const T& default_value = T()) {
+         auto itr = m.find (key);
+         if (itr == m.end()) {
+            return default_value;
+         }
+         T value = itr->second;
+         m.erase (itr);
+         return value;
+      }
 
       uint64_t get_next_sender_id()
       {
-         config_table      config_s (get_self(), get_self().value);
-   	   Config c = config_s.get_or_create (get_self(), Config());   
-         uint64_t return_senderid = c.ints.at("last_sender_id");
-         return_senderid++;
-         c.ints["last_sender_id"] = return_senderid;
-         config_s.set (c, get_self());
-         return return_senderid;
+         if (!sequences.exists ("senderid"_n)) {
+            // one-time move of the counter out of the config singleton
+            Config& c = config.modify();
+            sequences.set ("senderid"_n, c.ints.find("last_sender_id") != c.ints.end() ? c.ints.at("last_sender_id") : 0);
+            c.ints.erase ("last_sender_id");
+         }
+         return sequences.next ("senderid"_n);
       }
 
-      void debug (const string& notes) {
-         debug_table d_t (get_self(), get_self().value);
-         d_t.emplace (get_self(), [&](auto &d) {
-            d.debug_id = d_t.available_primary_key();
-            d.notes = notes;
-         });
+      name get_next_ballot_id()
+      {
+         if (!sequences.exists ("ballotid"_n)) {
+            // one-time move of the counter out of the config singleton
+            Config& c = config.modify();
+            check (c.names.find("last_ballot_id") != c.names.end(), errors::NAME_CONFIG_MISSING, "last_ballot_id");
+            sequences.set ("ballotid"_n, c.names.at("last_ballot_id").value);
+            c.names.erase ("last_ballot_id");
+         }
+         return name (sequences.next ("ballotid"_n));
+      }
+
+      // sends this contract's own action again as a deferred transaction, used by batched actions
+      template <typename... Args>
+      void reschedule (const name& action_name, Args&&... args) {
+         transaction trx {};
+         trx.actions.emplace_back(
+            permission_level{get_self(), "active"_n}, 
+            get_self(), action_name, 
+            std::make_tuple(std::forward<Args>(args)...));
+         trx.delay_sec = 1;
+         trx.send(get_next_sender_id(), get_self());
       }
 
-      void change_scope (const name& current_scope, const uint64_t& id, const name& new_scope, const bool& remove_old) {
+      // copies an object into another scope with a new id; used to promote a passed proposal
+      // into the scope of its type (role, assignment, ...)
+      uint64_t change_scope (const name& current_scope, const uint64_t& id, const name& new_scope) {
 
          object_table o_t_current (get_self(), current_scope.value);
 	      auto o_itr_current = o_t_current.find(id);
-	      check (o_itr_current != o_t_current.end(), "Scope: " + current_scope.to_string() + "; Object ID: " + std::to_string(id) + " does not exist.");
+	      check (o_itr_current != o_t_current.end(), errors::OBJECT_NOT_FOUND, current_scope, id);
+
+         object_body_table b_t_current (get_self(), current_scope.value);
+         auto b_itr_current = b_t_current.find(id);
+	      check (b_itr_current != b_t_current.end(), errors::OBJECT_BODY_NOT_FOUND, current_scope, id);
+
+         const uint64_t new_id = next_object_id (new_scope);
 
          object_table o_t_new (get_self(), new_scope.value);
 	      o_t_new.emplace (get_self(), [&](auto &o) {
-            o.id                          = o_t_new.available_primary_key();
-            o.names                       = o_itr_current->names;
-            o.names["prior_scope"]        = current_scope;
-            o.assets                      = o_itr_current->assets;
-            o.strings                     = o_itr_current->strings;
-            o.floats                      = o_itr_current->floats;
-            o.time_points                 = o_itr_current->time_points;
-            o.ints                        = o_itr_current->ints;
-            o.ints["prior_id"]            = o_itr_current->id;  
-            o.trxs                        = o_itr_current->trxs;
+            o                             = *o_itr_current;
+            o.id                          = new_id;
+            o.status                      = name();
+            o.created_date                = current_time_point();
+            o.updated_date                = current_time_point();
 	      });
 
-         if (remove_old) {
-            debug ("Erasing object from : " + current_scope.to_string() + "; copying to : " + new_scope.to_string());
-            o_t_current.erase (o_itr_current);
-         }
-      }
+         object_body_table b_t_new (get_self(), new_scope.value);
+	      b_t_new.emplace (get_self(), [&](auto &b) {
+            b                             = *b_itr_current;
+            b.id                          = new_id;
+            b.names["prior_scope"]        = current_scope;
+            b.ints["prior_id"]            = id;  
+	      });
 
-      asset adjust_asset (const asset& original_asset, const float& adjustment) {
-         return asset { static_cast<int64_t> (original_asset.amount * adjustment), original_asset.symbol };
-      }  
-      
-      float get_float (const std::map<string, uint64_t> ints, string key) {
-         return (float) ints.at(key) / (float) 100;
+         return new_id;
       }
 
       bool is_paused () {
-         config_table      config_s (get_self(), get_self().value);
-   	   Config c = config_s.get_or_create (get_self(), Config());   
-         check (c.ints.find ("paused") != c.ints.end(), "Contract does not have a pause configuration. Assuming it is paused. Please contact administrator.");
-         
-         uint64_t paused = c.ints.at("paused");
-         return paused == 1;
-      }
-
-      string get_string (const std::map<string, string> strings, string key) {
-         if (strings.find (key) != strings.end()) {
-            return strings.at(key);
-         } else {
-            return string {""};
-         }
+         check (config.has_int ("paused"), errors::NO_PAUSE_CONFIG);
+         return config.get_int ("paused") == 1;
       }
-
-      void checkx (const bool& condition, const string& message) {
-
-         if (condition) {
-            return;
-         }
-
-         transaction trx (time_point_sec(current_time_point())+ (60));
-         trx.actions.emplace_back(
-            permission_level{get_self(), "active"_n}, 
-            get_self(), "debugmsg"_n,
-            std::make_tuple(message));
-         trx.delay_sec = 0;
-         trx.send(get_next_sender_id(), get_self());
-
-         check (false, message);
-      }   
 };
 
 #endif
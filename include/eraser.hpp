@@ -0,0 +1,115 @@
+#ifndef ERASER_H
+#define ERASER_H
+
+#include <eosio/eosio.hpp>
+#include <eosio/multi_index.hpp>
+
+#include "errors.hpp"
+
+using namespace eosio;
+
+// Progress of a bulk erase that did not finish within one action.
+// job names the operation (the admin action that started it); scope is the scope of the erased table.
+struct [[eosio::table, eosio::contract("dao") ]] EraseJob
+{
+   uint64_t    job_id                  ;
+   name        job                     ;
+   name        scope                   ;
+   uint64_t    begin_key               = 0;     // first primary key to erase, as requested
+   uint64_t    next_key                = 0;     // first primary key not yet erased
+   uint64_t    end_key                 = 0;     // last primary key to erase (inclusive)
+   uint64_t    erased                  = 0;
+   uint64_t    remaining               = 0;     // upper bound, from the span of primary keys left
+
+   time_point  created_date = current_time_point();
+   time_point  updated_date = current_time_point();
+
+   uint64_t    primary_key()  const { return job_id; }
+   uint128_t   by_job()       const { return (uint128_t { job.value } << 64) | scope.value; }
+};
+
+typedef multi_index<"erasejobs"_n, EraseJob,
+   indexed_by<"byjob"_n, const_mem_fun<EraseJob, uint128_t, &EraseJob::by_job>>
+> erase_job_table;
+
+class BatchEraser {
+
+   public:
+
+      struct Result {
+         uint64_t    erased      = 0;
+         uint64_t    remaining   = 0;
+         bool        done        = true;
+      };
+
+      BatchEraser (const name& contract):
+         contract (contract),
+         job_t (contract, contract.value) {}
+
+      // Erases at most max_rows rows of table with primary keys in [begin_key, end_key].
+      // The cursor is kept in the erasejobs table, so calling again with the same job and
+      // scope resumes where the previous call stopped; the range must then be the same as the
+      // one the job was started with. The job row is removed when done.
+      template <typename Table>
+      Result erase (Table& table, const name& job, const name& scope,
+                     const uint64_t& begin_key, const uint64_t& end_key, const uint64_t& max_rows) {
+
+         auto job_index = job_t.get_index<"byjob"_n>();
+         auto j_itr = job_index.find ((uint128_t { job.value } << 64) | scope.value);
+
+         uint64_t next_key = begin_key;
+         if (j_itr != job_index.end()) {
+            // a different range would resume from a cursor that does not belong to it
+            check (j_itr->begin_key == begin_key && j_itr->end_key == end_key, errors::ERASE_RANGE_MISMATCH, 
+               job, scope, j_itr->begin_key, j_itr->end_key);
+            next_key = j_itr->next_key;
+         }
+
+         Result result;
+         auto itr = table.lower_bound (next_key);
+         while (itr != table.end() && itr->primary_key() <= end_key && result.erased < max_rows) {
+            itr = table.erase (itr);
+            result.erased++;
+         }
+
+         result.done = itr == table.end() || itr->primary_key() > end_key;
+         if (!result.done) {
+            next_key = itr->primary_key();
+            uint64_t last_key = std::min (end_key, std::prev (table.end())->primary_key());
+            result.remaining = last_key - next_key + 1;
+         }
+
+         if (result.done) {
+            if (j_itr != job_index.end()) {
+               job_index.erase (j_itr);
+            }
+         } else if (j_itr == job_index.end()) {
+            job_t.emplace (contract, [&](auto &j) {
+               j.job_id       = job_t.available_primary_key();
+               j.job          = job;
+               j.scope        = scope;
+               j.begin_key    = begin_key;
+               j.next_key     = next_key;
+               j.end_key      = end_key;
+               j.erased       = result.erased;
+               j.remaining    = result.remaining;
+            });
+         } else {
+            job_index.modify (j_itr, contract, [&](auto &j) {
+               j.next_key     = next_key;
+               j.erased       += result.erased;
+               j.remaining    = result.remaining;
+               j.updated_date = current_time_point();
+            });
+         }
+
+         print ("Erased ", result.erased, " rows from ", job, " in scope ", scope, "; ", result.remaining, " rows left.\n");
+         return result;
+      }
+
+   private:
+      name              contract;
+      erase_job_table   job_t;
+};
+
+#endif
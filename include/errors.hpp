@@ -0,0 +1,113 @@
+#ifndef ERRORS_H
+#define ERRORS_H
+
+#include <eosio/eosio.hpp>
+#include <eosio/asset.hpp>
+
+using namespace eosio;
+using std::string;
+
+// Every failure the contract reports, as X (identifier, code, message). Codes are part of the
+// interface: never renumber or reuse one. scripts/errors.js turns this list into the
+// code -> message table for clients (scripts/errors.json).
+#define DAO_ERRORS(X) \
+   X (PAUSED,                    1, "Contract is paused for maintenance. Please try again later.") \
+   X (NO_PAUSE_CONFIG,           2, "Contract does not have a pause configuration. Assuming it is paused. Please contact administrator.") \
+   X (MISSING_AUTHORITY,         3, "Authentication failed. Must have authority from account or contract") \
+   X (HIGHER_PERMISSION,         4, "Requires higher permission.") \
+   X (NAME_CONFIG_MISSING,       5, "name configuration is required but not provided") \
+   X (INT_CONFIG_MISSING,        6, "int configuration is required but not provided") \
+   X (SEQUENCE_NOT_INITIALIZED,  7, "Sequence has not been initialized") \
+   X (ZERO_BATCH_SIZE,           8, "Batch size must be greater than zero") \
+   X (OUT_OF_RANGE,              9, "Argument out of range") \
+   X (EMPTY_LIST,               10, "At least one entry is required") \
+   X (ALREADY_MEMBER,           11, "Account is already a member") \
+   X (NOT_MEMBER,               12, "Account is not a member") \
+   X (APPLICANT_NOT_FOUND,      13, "Applicant not found") \
+   X (DUPLICATE_APPLICANT,      14, "Applicant listed more than once") \
+   X (INVALID_LIST,             15, "list must be members or applicants") \
+   X (BALLOT_ID_USED,           16, "ballot_id has already been used") \
+   X (BALLOT_NOT_FOUND,         17, "ballot_id not found") \
+   X (OBJECT_NOT_FOUND,         18, "Object does not exist; scope, id") \
+   X (OBJECT_BODY_NOT_FOUND,    19, "Object body does not exist; scope, id") \
+   X (OBJECT_EXISTS,            20, "Object already exists in objectsv2; scope, id") \
+   X (PROPOSAL_NOT_OPEN,        21, "Proposal is not open; id, status") \
+   X (PROPOSAL_NOT_PASSED,      22, "Proposal has not passed; id, status") \
+   X (PROPOSAL_WITHOUT_TYPE,    23, "Proposal object does not have a type to promote object to") \
+   X (NO_EXPIRATION,            24, "Proposal has no expiration") \
+   X (VOTING_NOT_ENDED,         25, "Voting on proposal has not ended") \
+   X (VOTING_ENDED,             26, "Voting on proposal has ended") \
+   X (DECIDE_BALLOT,            27, "Proposal is voted on in telos decide") \
+   X (INVALID_VOTE_OPTION,      28, "Vote option must be pass or fail") \
+   X (NO_VOTE_BALANCE,          29, "Account has no VOTE balance") \
+   X (TREASURY_NOT_FOUND,       30, "Treasury not found") \
+   X (QUORUM_TOO_HIGH,          31, "quorum_bps must not exceed 10000") \
+   X (CHALLENGE_NOT_FOUND,      32, "Challenge does not exist") \
+   X (CHALLENGE_COMPLETED,      33, "Member has already completed challenge; member, challenge id") \
+   X (NO_PERIOD_FOR_TIME,       34, "No period contains the given time") \
+   X (PERIOD_RANGE,             35, "Begin period ID must not be after end period ID") \
+   X (PERIOD_DATES,             36, "Period start date must be before its end date") \
+   X (PERIOD_ORDER,             37, "Periods must be in time order and must not overlap") \
+   X (PERIOD_OVERLAP,           38, "Period overlaps stored period") \
+   X (CALENDAR_LENGTH,          39, "Calendar period length must be greater than zero") \
+   X (CALENDAR_IDS,             40, "Calendar period IDs must be less than NO_PERIOD") \
+   X (CALENDAR_END,             41, "Calendar must end before the latest representable time") \
+   X (ERASE_RANGE_MISMATCH,     42, "An erase job with a different range is pending; job, scope, begin, end") \
+   X (PERIOD_IN_CALENDAR,       43, "Period overlaps the calendar; use overperiod to replace a calendar period") \
+   X (NOT_CALENDAR_PERIOD,      44, "Period ID is not in the calendar") \
+   X (CALENDAR_IDS_STORED,      45, "Calendar period IDs include stored periods; first, last") \
+   X (NO_PENDING_EXECUTION,     46, "Proposal has no pending execution") \
+   X (TALLY_EXISTS,             47, "Proposal still has a tally; erase or compact the proposal first") \
+   X (VOTE_TRANSFERABLE,        48, "VOTE is transferable, so native vote weights cannot be pinned") \
+   X (TALLY_NOT_FOUND,          49, "Proposal tally does not exist") \
+   X (MULDIV_ZERO_DENOMINATOR,  50, "muldiv: denominator must be greater than zero") \
+   X (MULDIV_OVERFLOW,          51, "muldiv: result does not fit in 64 bits; numerator, denominator") \
+   X (PERIODS_NOT_MIGRATED,     52, "Periods have not been migrated; run migperiods") \
+   X (PERIODS_MIGRATED,         53, "Periods have already been migrated")
+
+namespace errors {
+
+   enum code : uint16_t {
+#define DAO_ERROR_ENUM(id, number, message) id = number,
+      DAO_ERRORS (DAO_ERROR_ENUM)
+#undef DAO_ERROR_ENUM
+   };
+
+   inline const char* message (const code& c) {
+      switch (c) {
+#define DAO_ERROR_MESSAGE(id, number, message) case id: return message;
+         DAO_ERRORS (DAO_ERROR_MESSAGE)
+#undef DAO_ERROR_MESSAGE
+      }
+      return "";
+   }
+
+   inline void append (string& s, const string& part)        { s += part; }
+   inline void append (string& s, const char* part)          { s += part; }
+   inline void append (string& s, const name& part)          { s += part.to_string(); }
+   inline void append (string& s, const symbol_code& part)   { s += part.to_string(); }
+   inline void append (string& s, const uint64_t& part)      { s += std::to_string (part); }
+
+   // builds "E<code> <message>: <details>" and aborts; only reached on the failure path
+   template <typename... Details>
+   [[noreturn]] void fail (const code& c, const Details&... details) {
+      string s = "E" + std::to_string (c) + " " + message (c);
+      if constexpr (sizeof...(details) > 0) {
+         s += ":";
+         ((s += " ", append (s, details)), ...);
+      }
+      eosio::check (false, s);
+      __builtin_unreachable();
+   }
+
+   // Pass details as raw values (names, ids, keys), not strings: nothing is converted or
+   // concatenated unless the condition is false.
+   template <typename... Details>
+   inline void check (const bool& condition, const code& c, const Details&... details) {
+      if (!condition) {
+         fail (c, details...);
+      }
+   }
+}
+
+#endif
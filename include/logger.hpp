@@ -0,0 +1,132 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <eosio/eosio.hpp>
+#include <eosio/asset.hpp>
+#include <eosio/multi_index.hpp>
+
+#include "config.hpp"
+#include "sequence.hpp"
+
+using namespace eosio;
+using std::string;
+
+// Lowest level compiled into the contract, set by the DAO_LOG_LEVEL CMake cache variable:
+// 0 debug, 1 info, 2 warn, 3 error, 4 none. Calls below that level expand to nothing, so
+// their arguments are neither evaluated nor formatted.
+#ifndef DAO_LOG_LEVEL
+#define DAO_LOG_LEVEL 2
+#endif
+
+#if DAO_LOG_LEVEL <= 0
+#define LOG_DEBUG(logger, ...)   (logger).log (Logger::DEBUG, __VA_ARGS__)
+#else
+#define LOG_DEBUG(logger, ...)   ((void)0)
+#endif
+
+#if DAO_LOG_LEVEL <= 1
+#define LOG_INFO(logger, ...)    (logger).log (Logger::INFO, __VA_ARGS__)
+#else
+#define LOG_INFO(logger, ...)    ((void)0)
+#endif
+
+#if DAO_LOG_LEVEL <= 2
+#define LOG_WARN(logger, ...)    (logger).log (Logger::WARN, __VA_ARGS__)
+#else
+#define LOG_WARN(logger, ...)    ((void)0)
+#endif
+
+#if DAO_LOG_LEVEL <= 3
+#define LOG_ERROR(logger, ...)   (logger).log (Logger::ERROR, __VA_ARGS__)
+#else
+#define LOG_ERROR(logger, ...)   ((void)0)
+#endif
+
+// One slot of the debug ring buffer. slot = sequence % debug_capacity, so once the
+// buffer is full each new entry overwrites the oldest one.
+struct [[eosio::table, eosio::contract("dao") ]] LogEntry
+{
+   uint64_t    slot                    ;
+   uint64_t    sequence                ;
+   uint8_t     level                   ;
+   string      notes                   ;
+   time_point  created_date = current_time_point();
+
+   uint64_t    primary_key()  const { return slot; }
+};
+
+typedef multi_index<"debuglog"_n, LogEntry> log_table;
+
+// Configuration (ints):
+//    debug_level    : lowest level that is written; 0 debug, 1 info, 2 warn, 3 error (default 0)
+//    debug_capacity : number of slots in the ring buffer; 0 disables the log (default 500)
+class Logger {
+
+   public:
+
+      static constexpr uint8_t   DEBUG             = 0;
+      static constexpr uint8_t   INFO              = 1;
+      static constexpr uint8_t   WARN              = 2;
+      static constexpr uint8_t   ERROR             = 3;
+
+      static constexpr uint64_t  DEFAULT_CAPACITY  = 500;
+
+      Logger (const name& contract, ConfigContext& config, Sequences& sequences):
+         contract (contract),
+         config (config),
+         sequences (sequences),
+         log_t (contract, contract.value) {}
+
+      bool enabled (const uint8_t& level) {
+         return level >= config.get_int ("debug_level", DEBUG) &&
+                  config.get_int ("debug_capacity", DEFAULT_CAPACITY) > 0;
+      }
+
+      // the parts are only concatenated when the level is enabled at runtime
+      template <typename... Parts>
+      void log (const uint8_t& level, const Parts&... parts) {
+         if (!enabled (level)) {
+            return;
+         }
+
+         string notes;
+         (append (notes, parts), ...);
+
+         if (!sequences.exists ("debuglog"_n)) {
+            sequences.set ("debuglog"_n, 0);
+         }
+         uint64_t sequence = sequences.next ("debuglog"_n);
+         uint64_t slot = sequence % config.get_int ("debug_capacity", DEFAULT_CAPACITY);
+
+         auto l_itr = log_t.find (slot);
+         if (l_itr == log_t.end()) {
+            log_t.emplace (contract, [&](auto &l) {
+               l.slot            = slot;
+               l.sequence        = sequence;
+               l.level           = level;
+               l.notes           = notes;
+            });
+         } else {
+            log_t.modify (l_itr, contract, [&](auto &l) {
+               l.sequence        = sequence;
+               l.level           = level;
+               l.notes           = notes;
+               l.created_date    = current_time_point();
+            });
+         }
+      }
+
+   private:
+      static void append (string& s, const string& part)     { s += part; }
+      static void append (string& s, const char* part)       { s += part; }
+      static void append (string& s, const name& part)       { s += part.to_string(); }
+      static void append (string& s, const asset& part)      { s += part.to_string(); }
+      static void append (string& s, const uint64_t& part)   { s += std::to_string (part); }
+
+      name              contract;
+      ConfigContext&    config;
+      Sequences&        sequences;
+      log_table         log_t;
+};
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef SEQUENCE_H
+#define SEQUENCE_H
+
+#include <eosio/eosio.hpp>
+#include <eosio/multi_index.hpp>
+
+#include "errors.hpp"
+
+using namespace eosio;
+
+// Fixed-size counter rows, one per key. Bumping a counter rewrites 16 bytes
+// instead of the whole Config blob.
+struct [[eosio::table, eosio::contract("dao") ]] Sequence
+{
+   name        key               ;
+   uint64_t    value             = 0;
+
+   uint64_t    primary_key()     const { return key.value; }
+};
+
+typedef multi_index<"sequences"_n, Sequence> sequence_table;
+
+class Sequences {
+
+   public:
+
+      // counters live in the contract scope unless a scope is given, e.g. one per object scope
+      Sequences (const name& contract, const name& scope = name()):
+         contract (contract),
+         sequence_t (contract, scope == name() ? contract.value : scope.value) {}
+
+      bool exists (const name& key) {
+         return sequence_t.find (key.value) != sequence_t.end();
+      }
+
+      uint64_t current (const name& key) {
+         auto s_itr = sequence_t.find (key.value);
+         check (s_itr != sequence_t.end(), errors::SEQUENCE_NOT_INITIALIZED, key);
+         return s_itr->value;
+      }
+
+      // increments the counter and returns the new value
+      uint64_t next (const name& key) {
+         auto s_itr = sequence_t.find (key.value);
+         check (s_itr != sequence_t.end(), errors::SEQUENCE_NOT_INITIALIZED, key);
+         uint64_t next_value = s_itr->value + 1;
+         sequence_t.modify (s_itr, contract, [&](auto &s) {
+            s.value = next_value;
+         });
+         return next_value;
+      }
+
+      void set (const name& key, const uint64_t& value) {
+         auto s_itr = sequence_t.find (key.value);
+         if (s_itr == sequence_t.end()) {
+            sequence_t.emplace (contract, [&](auto &s) {
+               s.key    = key;
+               s.value  = value;
+            });
+         } else {
+            sequence_t.modify (s_itr, contract, [&](auto &s) {
+               s.value  = value;
+            });
+         }
+      }
+
+   private:
+      name              contract;
+      sequence_table    sequence_t;
+};
+
+#endif
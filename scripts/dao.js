@@ -76,7 +76,11 @@ async function getProposals (host, contract) {
   options.code = contract;
   options.json = true;
   options.scope = "proposal";
-  options.table = "objects";
+  options.table = "objectsv2";
+  options.index_position = 7; // index #7 is "bystatus"
+  options.key_type = 'name';
+  options.lower_bound = "open";
+  options.upper_bound = "open";
   options.reverse = false;
   options.limit = 100;
   
@@ -97,7 +101,7 @@ async function getProposal (host, contract, proposal_id) {
   options.code = contract;
   options.json = true;
   options.scope = "proposal";
-  options.table = "objects";
+  options.table = "objectsv2";
   options.upper_bound = proposal_id;
   options.lower_bound = proposal_id;
   options.limit = 1;
@@ -121,7 +125,7 @@ async function getLastCreatedProposal (host, contract) {
 
   options.json = true;
   options.scope = "proposal";
-  options.table = "objects";
+  options.table = "objectsv2";
   options.index_position = 2; // index #2 is "bycreated"
   options.key_type = 'i64';
   options.reverse = true;
@@ -136,19 +140,20 @@ async function getLastCreatedProposal (host, contract) {
   return undefined;  
 }
 
+// periods per addperiods action
+const PERIOD_BATCH_SIZE = 50
+
 const addPeriod = async (prod, host, contract, periods) => {
 
-//async function addPeriods (prod, host, contract, periods) {
-  for (let i = 0; i < periods.length; i++) {
+  for (let i = 0; i < periods.length; i += PERIOD_BATCH_SIZE) {
+    const batch = periods.slice(i, i + PERIOD_BATCH_SIZE)
     try {
-      const { startdate, enddate } = periods[i]
-      console.log ("Adding a period: ", startdate)
-      await sendtrx (prod, host, contract, "addperiod", contract, {
-        start_time: startdate,
-        end_time: enddate
+      console.log ("Adding periods starting: ", batch[0].startdate)
+      await sendtrx (prod, host, contract, "addperiods", contract, {
+        periods: batch.map(({ startdate, enddate }) => ({ first: startdate, second: enddate }))
       });
 
-      console.log("Successfully created phase: ", startdate)
+      console.log("Successfully added periods through: ", batch[batch.length - 1].enddate)
     } catch (e) {
       console.error(e)
       console.log('Please, fix an error and run script again')
@@ -157,11 +162,48 @@ const addPeriod = async (prod, host, contract, periods) => {
   }
 }
 
-const addPeriods = (file, prod, host, contract) => {
+// returns the calendar (epoch, length, count) that generates the periods, or undefined
+// if they are not back-to-back periods of the same length with sequential ids
+const toCalendar = (periods) => {
+  const seconds = (date) => Date.parse(date + "Z") / 1000
+  const length = seconds(periods[0].enddate) - seconds(periods[0].startdate) + 1
+  for (let i = 0; i < periods.length; i++) {
+    const start = seconds(periods[0].startdate) + i * length
+    if (seconds(periods[i].startdate) !== start ||
+        seconds(periods[i].enddate) !== start + length - 1 ||
+        Number(periods[i].period) !== Number(periods[0].period) + i) {
+      return undefined
+    }
+  }
+  return {
+    epoch: periods[0].startdate,
+    length_sec: length,
+    count: periods.length,
+    first_period_id: Number(periods[0].period)
+  }
+}
+
+const setCalendar = async (prod, host, contract, periods) => {
+  const calendar = toCalendar(periods)
+  if (calendar === undefined) {
+    console.log ("Periods are not regular; adding them as rows")
+    return addPeriod(prod, host, contract, periods)
+  }
+
+  try {
+    console.log ("Setting the period calendar: ", JSON.stringify(calendar))
+    await sendtrx (prod, host, contract, "setcalendar", contract, calendar);
+  } catch (e) {
+    console.error(e)
+    process.exit (1);
+  }
+}
+
+const addPeriods = (file, prod, host, contract, calendar) => {
   let periods = []
   const handler = csv.parse({ headers: true })
   handler.on('data', row => periods.push(row))
-  handler.on('end', () => addPeriod(prod, host, contract, periods))
+  handler.on('end', () => calendar ? setCalendar(prod, host, contract, periods) : addPeriod(prod, host, contract, periods))
   fs.createReadStream(file).pipe(handler)
 }
 
@@ -177,6 +219,8 @@ async function loadOptions() {
     { name: "host", alias: "h", type: String, defaultValue: "https://test.telos.kitchen" },
     { name: "contract", type: String, defaultValue: "mygenericdao" },
     { name: "periods", type: Boolean, defaultValue: false },
+    // with --periods, load a regular CSV as one setcalendar action instead of a row per period
+    { name: "calendar", type: Boolean, defaultValue: false },
     // extra safeguard, must also set key, host, and contract to prod
     { name: "prod", type: Boolean, defaultValue: false},  
 
@@ -193,9 +237,14 @@ async function loadOptions() {
     // close a specific proposal id    
     { name: "closepropid", type: String},
 
-    // loop through all open proposals and try to close them
-    // does not halt on first error, reports error if close not possible
+    // close expired proposals with one closeprops action
     { name: "closeall", type: Boolean, defaultValue: false},
+    // close due proposals from the contract's expiry queue; safe to run every block
+    { name: "crank", type: Boolean, defaultValue: false },
+    // run the action of a proposal passed by closeprops or crank
+    { name: "execpropid", type: String},
+    // number of expired ballots or queue entries examined by one closeprops or crank action
+    { name: "max_count", type: Number, defaultValue: 20 },
 
     // set a config
     { name: "config", type: Boolean, defaultValue: false },    
@@ -284,13 +333,13 @@ const main = async () => {
         console.log ("\Approving the proposal");
         console.log ("-- calling trailservice::castvote with the following parms:");
         console.log ("-- -- voter       : ", proposal.data.names.find(o => o.key === 'owner').value);
-        console.log ("-- -- ballot_id   : ", lastProposal.names.find(o => o.key === 'ballot_id').value);
+        console.log ("-- -- ballot_id   : ", lastProposal.ballot_id);
         console.log ("-- -- options     : ", options);
   
         await sendtrx(opts.prod, opts.host, "telos.decide", "castvote", 
           proposal.data.names.find(o => o.key === 'owner').value, 
           { "voter":proposal.data.names.find(o => o.key === 'owner').value, 
-            "ballot_name":lastProposal.names.find(o => o.key === 'ballot_id').value, 
+            "ballot_name":lastProposal.ballot_id, 
             "options":options });
       }
   
@@ -312,10 +361,15 @@ const main = async () => {
     }
   } else if (opts.closeall) {
 
-      let proposals = await getProposals(opts.host, opts.contract)
-      proposals.forEach (async function (proposal) {
-        await closeProposal (opts.prod, opts.host, opts.contract, proposal);
-      });      
+      // one bounded action closes the expired proposals in ballot end-time order
+      await sendtrx(opts.prod, opts.host, opts.contract, "closeprops", opts.contract,
+        { "max_count": opts.max_count });
+  } else if (opts.crank) {
+      await sendtrx(opts.prod, opts.host, opts.contract, "crank", opts.contract,
+        { "max_work": opts.max_count });
+  } else if (opts.execpropid) {
+      await sendtrx(opts.prod, opts.host, opts.contract, "execprop", opts.contract,
+        { "proposal_id": opts.execpropid });
   } else if (opts.closepropid) {
     await closeProposal (opts.prod, opts.host, opts.contract, await getProposal (opts.host, opts.closepropid))
   } else if (opts.print_proposal) {
@@ -323,7 +377,7 @@ const main = async () => {
   } else if (opts.file && opts.periods) {
       // const proposal = JSON.parse(fs.readFileSync(opts.file.filename, 'utf8'));
       //    const loadPeriods = () => {
-      addPeriods(opts.file.filename, opts.prod, opts.host, opts.contract)
+      addPeriods(opts.file.filename, opts.prod, opts.host, opts.contract, opts.calendar)
     } else {
     console.log ("Command unsupported. You used: ", JSON.stringify(opts, null, 2));
   }  
@@ -0,0 +1,27 @@
+/*
+
+Generates the error code -> message table from the DAO_ERRORS list in include/errors.hpp.
+Contract failures read "E<code> <message>: <details>"; clients look the code up in this table.
+
+node errors.js > errors.json
+++++++++++++++++++++++++++++++++++++++++++++++++++++++ 
+*/
+
+const fs = require('fs');
+const path = require('path');
+
+const header = fs.readFileSync(path.join(__dirname, '..', 'include', 'errors.hpp'), 'utf8');
+const pattern = /X \((\w+),\s*(\d+),\s*"((?:[^"\\]|\\.)*)"\)/g;
+
+let errors = {};
+let match;
+while ((match = pattern.exec(header)) !== null) {
+  const [, id, code, message] = match;
+  if (errors[code]) {
+    console.error("Duplicate error code: ", code);
+    process.exit (1);
+  }
+  errors[code] = { id: id, message: message };
+}
+
+console.log(JSON.stringify(errors, null, 2));
@@ -1,53 +1,219 @@
 #include <dao.hpp>
 
 void dao::addmember (const name& member) {
+	check (!is_paused(), errors::PAUSED);
 	require_auth (get_self());
 	member_table m_t (get_self(), get_self().value);
 	auto m_itr = m_t.find (member.value);
-	check (m_itr == m_t.end(), "Account is already a member: " + member.to_string());
+	check (m_itr == m_t.end(), errors::ALREADY_MEMBER, member);
 	m_t.emplace (get_self(), [&](auto &m) {
 		m.member = member;
 	});
+	adjust_stats (1, 0);
 }
 
 void dao::removemember (const name& member) {
+	check (!is_paused(), errors::PAUSED);
 	require_auth (get_self());
 	member_table m_t (get_self(), get_self().value);
 	auto m_itr = m_t.find (member.value);
-	check (m_itr != m_t.end(), "Account is not a member: " + member.to_string());
+	check (m_itr != m_t.end(), errors::NOT_MEMBER, member);
 	m_t.erase (m_itr);
+	adjust_stats (-1, 0);
 }
 
-void dao::eraseobjs (const name& scope) {
+void dao::recount (const uint64_t& batch_size) {
 	require_auth (get_self());
+	check (batch_size > 0, errors::ZERO_BATCH_SIZE);
+
+	recount_table r_s (get_self(), get_self().value);
+	Recount r = r_s.get_or_default (Recount { "members"_n });
+
+	uint64_t count = 0;
+	if (r.list == "members"_n) {
+		member_table m_t (get_self(), get_self().value);
+		auto m_itr = m_t.lower_bound (r.next_key);
+		for (; m_itr != m_t.end() && count < batch_size; m_itr++, count++) {
+			r.members++;
+		}
+		if (m_itr == m_t.end()) {
+			r.list = "applicants"_n;
+			r.next_key = 0;
+		} else {
+			r.next_key = m_itr->primary_key();
+		}
+	}
+
+	if (r.list == "applicants"_n) {
+		applicant_table a_t (get_self(), get_self().value);
+		auto a_itr = a_t.lower_bound (r.next_key);
+		for (; a_itr != a_t.end() && count < batch_size; a_itr++, count++) {
+			r.applicants++;
+		}
+		if (a_itr == a_t.end()) {
+			stats_table s_s (get_self(), get_self().value);
+			s_s.set (Stats { r.members, r.applicants }, get_self());
+			r_s.remove();
+			return;
+		}
+		r.next_key = a_itr->primary_key();
+	}
+
+	r_s.set (r, get_self());
+	reschedule ("recount"_n, batch_size);
+}
+
+void dao::getroster (const name& list, const name& lower_bound, const uint64_t& limit) {
+	check (limit > 0 && limit <= 500, errors::OUT_OF_RANGE, "limit", limit);
+
+	stats_table s_s (get_self(), get_self().value);
+	const Stats stats = s_s.get_or_default (Stats());
+	print ("{\"members\":", stats.members, ",\"applicants\":", stats.applicants, ",\"rows\":[");
+
+	uint64_t count = 0;
+	name next;
+	auto print_page = [&](auto& table) {
+		auto itr = table.lower_bound (lower_bound.value);
+		for (; itr != table.end() && count < limit; itr++, count++) {
+			print (count > 0 ? ",\"" : "\"", name (itr->primary_key()), "\"");
+		}
+		if (itr != table.end()) {
+			next = name (itr->primary_key());
+		}
+	};
+
+	if (list == "members"_n) {
+		member_table m_t (get_self(), get_self().value);
+		print_page (m_t);
+	} else {
+		check (list == "applicants"_n, errors::INVALID_LIST, list);
+		applicant_table a_t (get_self(), get_self().value);
+		print_page (a_t);
+	}
+
+	// next is empty on the last page
+	print ("],\"next\":\"", next, "\"}");
+}
+
+void dao::adjust_stats (const int64_t& members, const int64_t& applicants) {
+	stats_table s_s (get_self(), get_self().value);
+	Stats stats = s_s.get_or_default (Stats());
+	// counters never go below zero, even if they were started after rows already existed
+	stats.members		= members < 0 && stats.members < static_cast<uint64_t> (-members) ? 0 : stats.members + members;
+	stats.applicants	= applicants < 0 && stats.applicants < static_cast<uint64_t> (-applicants) ? 0 : stats.applicants + applicants;
+	stats.updated_date	= current_time_point();
+	s_s.set (stats, get_self());
+}
+
+void dao::eraseobjs (const name& scope, const uint64_t& batch_size) {
+	require_auth (get_self());
+	check (batch_size > 0, errors::ZERO_BATCH_SIZE);
+
+	// headers, then bodies, then rows never migrated out of the legacy objects table
 	object_table o_t (get_self(), scope.value);
-	auto o_itr = o_t.begin();
-	while (o_itr != o_t.end()) {
-		o_itr = o_t.erase (o_itr);
+	auto result = eraser.erase (o_t, "eraseobjs"_n, scope, 0, std::numeric_limits<uint64_t>::max(), batch_size);
+	uint64_t erased = result.erased;
+
+	if (result.done && erased < batch_size) {
+		object_body_table b_t (get_self(), scope.value);
+		result = eraser.erase (b_t, "erasebodies"_n, scope, 0, std::numeric_limits<uint64_t>::max(), batch_size - erased);
+		erased += result.erased;
+	} else {
+		result.done = false;
+	}
+
+	if (result.done && erased < batch_size) {
+		legacy_object_table l_t (get_self(), scope.value);
+		result = eraser.erase (l_t, "eraselegacy"_n, scope, 0, std::numeric_limits<uint64_t>::max(), batch_size - erased);
+		erased += result.erased;
+	} else {
+		result.done = false;
+	}
+
+	// native tallies and queued executions belong to proposals; receipts are left to clrreceipts
+	if (scope == "proposal"_n) {
+		if (result.done && erased < batch_size) {
+			tally_table t_t (get_self(), get_self().value);
+			result = eraser.erase (t_t, "erasetallies"_n, scope, 0, std::numeric_limits<uint64_t>::max(), batch_size - erased);
+			erased += result.erased;
+		} else {
+			result.done = false;
+		}
+
+		if (result.done && erased < batch_size) {
+			pending_exec_table p_t (get_self(), get_self().value);
+			result = eraser.erase (p_t, "erasepending"_n, scope, 0, std::numeric_limits<uint64_t>::max(), batch_size - erased);
+		} else {
+			result.done = false;
+		}
+	}
+
+	if (!result.done) {
+		reschedule ("eraseobjs"_n, scope, batch_size);
+	}
+}
+
+void dao::clrreceipts (const uint64_t& proposal_id, const uint64_t& batch_size) {
+	require_auth (get_self());
+	check (batch_size > 0, errors::ZERO_BATCH_SIZE);
+
+	// while the tally exists the receipts are needed to replace changed votes
+	tally_table t_t (get_self(), get_self().value);
+	check (t_t.find (proposal_id) == t_t.end(), errors::TALLY_EXISTS, proposal_id);
+
+	receipt_table r_t (get_self(), proposal_id);
+	if (!eraser.erase (r_t, "clrreceipts"_n, name (proposal_id), 0, std::numeric_limits<uint64_t>::max(), batch_size).done) {
+		reschedule ("clrreceipts"_n, proposal_id, batch_size);
 	}
 }
 
+void dao::reset (const uint64_t& batch_size) {
+	require_auth (get_self());
+	check (batch_size > 0, errors::ZERO_BATCH_SIZE);
+	if (!bank.reset (batch_size).done) {
+		reschedule ("reset"_n, batch_size);
+	}
+}
+
+void dao::eraseobj (const name& scope, const uint64_t& id) {
+	require_auth (get_self());
+	erase_object (scope, id);
+}
+
 void dao::togglepause () {
 	require_auth (get_self());
-	config_table      config_s (get_self(), get_self().value);
-   	Config c = config_s.get_or_create (get_self(), Config());   
+	Config& c = config.modify();
 	if (c.ints.find ("paused") == c.ints.end() || c.ints.at("paused") == 0) {
 		c.ints["paused"]	= 1;
 	} else {
 		c.ints["paused"] 	= 0;
 	} 	
-	config_s.set (c, get_self());
 }
 
 void dao::remperiods (const uint64_t& begin_period_id, 
-                           const uint64_t& end_period_id) {
+                           const uint64_t& end_period_id,
+                           const uint64_t& batch_size) {
+	require_auth (get_self());
+	check (batch_size > 0, errors::ZERO_BATCH_SIZE);
+	if (!bank.remove_periods (begin_period_id, end_period_id, batch_size).done) {
+		reschedule ("remperiods"_n, begin_period_id, end_period_id, batch_size);
+	}
+}
+
+void dao::compactpays (const uint64_t& batch_size) {
 	require_auth (get_self());
-    bank.remove_periods (begin_period_id, end_period_id);
+	check (batch_size > 0, errors::ZERO_BATCH_SIZE);
+	if (!bank.compact_payments (batch_size)) {
+		reschedule ("compactpays"_n, batch_size);
+	}
 }
 
-void dao::resetperiods () {
+void dao::resetperiods (const uint64_t& batch_size) {
 	require_auth (get_self());
-	bank.reset_periods();
+	check (batch_size > 0, errors::ZERO_BATCH_SIZE);
+	if (!bank.reset_periods (batch_size).done) {
+		reschedule ("resetperiods"_n, batch_size);
+	}
 }
 
 void dao::setconfig (	const map<string, name> 		names,
@@ -60,108 +226,126 @@ void dao::setconfig (	const map<string, name> 		names,
 {
 	require_auth (get_self());
 
-	config_table      config_s (get_self(), get_self().value);
-   	Config c = config_s.get_or_create (get_self(), Config());   
+	Config& c = config.modify();
 
-	// retain last_ballot_id from the current configuration if it is not provided in the new one
-	name last_ballot_id	;
-	if (names.find("last_ballot_id") != names.end()) { 
-		last_ballot_id	= names.at("last_ballot_id"); 
-	} else if (c.names.find("last_ballot_id") != c.names.end()) {
-		last_ballot_id	= c.names.at("last_ballot_id");
+	// the last_ballot_id and last_sender_id counters live in the sequences table;
+	// seed them from the payload when provided, otherwise from the prior configuration
+	if (names.find("last_ballot_id") != names.end()) {
+		sequences.set ("ballotid"_n, names.at("last_ballot_id").value);
+	} else if (!sequences.exists ("ballotid"_n) && c.names.find("last_ballot_id") != c.names.end()) {
+		sequences.set ("ballotid"_n, c.names.at("last_ballot_id").value);
 	}
 
-	c.names						= names;
-	c.names["last_ballot_id"] 	= last_ballot_id;
+	if (ints.find("last_sender_id") != ints.end()) {
+		sequences.set ("senderid"_n, ints.at("last_sender_id"));
+	} else if (!sequences.exists ("senderid"_n) && c.ints.find("last_sender_id") != c.ints.end()) {
+		sequences.set ("senderid"_n, c.ints.at("last_sender_id"));
+	}
+
+	c.names			= names;
+	c.names.erase ("last_ballot_id");
 
 	c.strings		= strings;
 	c.assets		= assets;
 	c.time_points	= time_points;
 	c.ints			= ints;
+	c.ints.erase ("last_sender_id");
 	c.floats		= floats;
 	c.trxs			= trxs;
 
-	config_s.set (c, get_self());
-
 	// validate for required configurations
-    string required_names[]{ "reward_token_contract", "telos_decide_contract", "last_ballot_id"};
+    string required_names[]{ "reward_token_contract", "telos_decide_contract"};
     for (int i{ 0 }; i < std::size(required_names); i++) {
-		check (c.names.find(required_names[i]) != c.names.end(), "name configuration: " + required_names[i] + " is required but not provided.");
+		check (c.names.find(required_names[i]) != c.names.end(), errors::NAME_CONFIG_MISSING, required_names[i]);
 	}
+	check (sequences.exists ("ballotid"_n), errors::NAME_CONFIG_MISSING, "last_ballot_id");
 }
 
 void dao::updversion (const string& component, const string& version) {
-	config_table      config_s (get_self(), get_self().value);
-   	Config c = config_s.get_or_create (get_self(), Config());   
-	c.strings[component] = version;
-	config_s.set (c, get_self());
+	config.modify().strings[component] = version;
 }
 
 void dao::setlastballt ( const name& last_ballot_id) {
 	require_auth (get_self());
-	config_table      config_s (get_self(), get_self().value);
-   	Config c = config_s.get_or_create (get_self(), Config());   
-	c.names["last_ballot_id"]			=	last_ballot_id;
-	config_s.set (c, get_self());
+	sequences.set ("ballotid"_n, last_ballot_id.value);
 }
 
 void dao::enroll (	const name& enroller,
 					const name& applicant, 
 					const string& content) {
 
-	check ( !is_paused(), "Contract is paused for maintenance. Please try again later.");	
+	enroll_applicants ({ applicant });
+}	
 
-	// this action is linked to the daomain@enrollers permission
-	applicant_table a_t (get_self(), get_self().value);
-	auto a_itr = a_t.find (applicant.value);
-	check (a_itr != a_t.end(), "Applicant not found: " + applicant.to_string());
+void dao::enrollmany (const name& enroller, const vector<name>& applicants, const string& content) {
+	check (applicants.size() > 0, errors::EMPTY_LIST, "applicants");
+	enroll_applicants (applicants);
+}
+
+void dao::enroll_applicants (const vector<name>& applicants) {
 
-	config_table      config_s (get_self(), get_self().value);
-   	Config c = config_s.get_or_create (get_self(), Config());  
+	check (!is_paused(), errors::PAUSED);	
+
+	// enroll and enrollmany are linked to the daomain@enrollers permission, which only applies
+	// if the contract's authority is required; the enroller argument is informational
+	require_auth (get_self());
+	applicant_table a_t (get_self(), get_self().value);
+	member_table m_t (get_self(), get_self().value);
 
-	asset one_vote = asset { 100, common::S_VOTE };
-	string memo { "Welcome to the DAO!"};
-	action(	
-		permission_level{get_self(), "active"_n}, 
-		c.names.at("telos_decide_contract"), "mint"_n, 
-		make_tuple(applicant, one_vote, memo))
-	.send();
+	// everything is checked before the first row is written
+	std::set<name> seen;
+	for (const name& applicant : applicants) {
+		check (seen.insert (applicant).second, errors::DUPLICATE_APPLICANT, applicant);
+		check (a_t.find (applicant.value) != a_t.end(), errors::APPLICANT_NOT_FOUND, applicant);
+		check (m_t.find (applicant.value) == m_t.end(), errors::ALREADY_MEMBER, applicant);
+	}
 
 	// Should we also send 1 REWARD?  I think so, so I'll put it for now, but comment it out
-	asset one_reward = asset { 1, common::S_REWARD };
-	bank.makepayment (-1, applicant, one_reward, memo, common::NO_ASSIGNMENT, 1);
+	const asset one_vote = asset { 100, common::S_VOTE };
+	const asset one_reward = asset { 1, common::S_REWARD };
+	const string memo { "Welcome to the DAO!"};
+
+	vector<Bank::PaymentRequest> payments;
+	payments.reserve (applicants.size() * 2);
+	for (const name& applicant : applicants) {
+		m_t.emplace (get_self(), [&](auto &m) {
+			m.member = applicant;
+		});
+		a_t.erase (a_t.find (applicant.value));
 
-	member_table m_t (get_self(), get_self().value);
-	auto m_itr = m_t.find (applicant.value);
-	check (m_itr == m_t.end(), "Account is already a member: " + applicant.to_string());
-	m_t.emplace (get_self(), [&](auto &m) {
-		m.member = applicant;
-	});
+		payments.push_back (Bank::PaymentRequest { common::NO_PERIOD, applicant, one_vote, memo });
+		payments.push_back (Bank::PaymentRequest { common::NO_PERIOD, applicant, one_reward, memo });
+	}
 
-	a_t.erase (a_itr);
-}	
+	// one mint per applicant, one REWARD issue for the batch and one transfer per applicant
+	bank.makepayments (payments);
+	adjust_stats (applicants.size(), -static_cast<int64_t> (applicants.size()));
+}
 
 void dao::remapply (const name& applicant) {
+	check (!is_paused(), errors::PAUSED);
 	require_auth (get_self());
 	applicant_table a_t (get_self(), get_self().value);
 	auto a_itr = a_t.find (applicant.value);
+	check (a_itr != a_t.end(), errors::APPLICANT_NOT_FOUND, applicant);
 	a_t.erase (a_itr);
+	adjust_stats (0, -1);
 }
 
 void dao::debugmsg (const string& message) {
 	require_auth (get_self());
-	debug (message);
+	LOG_ERROR (logger, message);
 }
 
 void dao::apply (const name& applicant, 
 						const string& content) {
 
-	check ( !is_paused(), "Contract is paused for maintenance. Please try again later.");	
+	check (!is_paused(), errors::PAUSED);	
 	require_auth (applicant);
 
 	member_table m_t (get_self(), get_self().value);
 	auto m_itr = m_t.find (applicant.value);
-	check (m_itr == m_t.end(), "Applicant is already a member: " + applicant.to_string());
+	check (m_itr == m_t.end(), errors::ALREADY_MEMBER, applicant);
 
 	applicant_table a_t (get_self(), get_self().value);
 	auto a_itr = a_t.find (applicant.value);
@@ -176,28 +360,60 @@ void dao::apply (const name& applicant,
 			a.applicant = applicant;
 			a.content = content;
 		});
+		adjust_stats (0, 1);
 	}
 }				
 
 name dao::register_ballot (const name& proposer, 
-							const map<string, string>& strings) 
+							const string& title,
+							const string& description,
+							const string& content,
+							const time_point_sec& expiration) 
 {
-	check (has_auth (proposer) || has_auth(get_self()), "Authentication failed. Must have authority from proposer: " +
-		proposer.to_string() + "@active or " + get_self().to_string() + "@active.");
+	check (has_auth (proposer) || has_auth(get_self()), errors::MISSING_AUTHORITY, proposer, get_self());
 	
 	qualify_proposer(proposer);
 
-	config_table      config_s (get_self(), get_self().value);
-   	Config c = config_s.get_or_create (get_self(), Config());  
-	
-	// increment the ballot_id
-	name new_ballot_id = name (c.names.at("last_ballot_id").value + 1);
-	c.names["last_ballot_id"] = new_ballot_id;
-	config_s.set(c, get_self());
-	
-	decidespace::decide::ballots_table b_t (c.names.at("telos_decide_contract"), c.names.at("telos_decide_contract").value);
+	const name decide_contract = config.get_name("telos_decide_contract");
+
+	// a pre-created ballot from the pool only needs its details and opening
+	name new_ballot_id;
+	ballot_pool_table bp_t (get_self(), get_self().value);
+	auto bp_itr = bp_t.begin();
+	if (bp_itr != bp_t.end()) {
+		new_ballot_id = bp_itr->ballot_id;
+		bp_t.erase (bp_itr);
+	} else {
+		new_ballot_id = new_ballot();
+	}
+
+   action (
+	   	permission_level{get_self(), "active"_n},
+		decide_contract, "editdetails"_n,
+		std::make_tuple(
+			new_ballot_id, 
+			title, 
+			description,
+			content))
+   .send();
+
+   action (
+      permission_level{get_self(), "active"_n},
+      decide_contract, "openvoting"_n,
+      std::make_tuple(new_ballot_id, expiration))
+   .send();
+
+	return new_ballot_id;
+}
+
+// sends newballot for the next ballot id; the ballot stays in setup state until opened
+name dao::new_ballot () {
+	name new_ballot_id = get_next_ballot_id();
+
+	const name decide_contract = config.get_name("telos_decide_contract");
+	decidespace::decide::ballots_table b_t (decide_contract, decide_contract.value);
 	auto b_itr = b_t.find (new_ballot_id.value);
-	check (b_itr == b_t.end(), "ballot_id: " + new_ballot_id.to_string() + " has already been used.");
+	check (b_itr == b_t.end(), errors::BALLOT_ID_USED, new_ballot_id);
 
 	vector<name> options;
    	options.push_back ("pass"_n);
@@ -205,7 +421,7 @@ name dao::register_ballot (const name& proposer,
 
 	action (
       permission_level{get_self(), "active"_n},
-      c.names.at("telos_decide_contract"), "newballot"_n,
+      decide_contract, "newballot"_n,
       std::make_tuple(
 			new_ballot_id, 
 			"poll"_n, 
@@ -222,25 +438,20 @@ name dao::register_ballot (const name& proposer,
 	//       std::make_tuple(new_ballot_id, "votestake"_n))
 	//    .send();
 
-   action (
-	   	permission_level{get_self(), "active"_n},
-		c.names.at("telos_decide_contract"), "editdetails"_n,
-		std::make_tuple(
-			new_ballot_id, 
-			strings.at("title"), 
-			strings.at("description"),
-			strings.at("content")))
-   .send();
+	return new_ballot_id;
+}
 
-   auto expiration = time_point_sec(current_time_point()) + c.ints.at("voting_duration_sec");
-   
-   action (
-      permission_level{get_self(), "active"_n},
-      c.names.at("telos_decide_contract"), "openvoting"_n,
-      std::make_tuple(new_ballot_id, expiration))
-   .send();
+void dao::fillpool (const uint64_t& count) {
+	require_auth (get_self());
+	check (count > 0 && count <= 50, errors::OUT_OF_RANGE, "count", count);
 
-	return new_ballot_id;
+	ballot_pool_table bp_t (get_self(), get_self().value);
+	for (uint64_t i = 0; i < count; i++) {
+		const name ballot_id = new_ballot();
+		bp_t.emplace (get_self(), [&](auto &bp) {
+			bp.ballot_id = ballot_id;
+		});
+	}
 }
 
 void dao::create (const name&						scope,
@@ -252,71 +463,259 @@ void dao::create (const name&						scope,
 					const map<string, float>        floats,
 					const map<string, transaction>  trxs)
 {
-	check ( !is_paused(), "Contract is paused for maintenance. Please try again later.");	
+	check (!is_paused(), errors::PAUSED);	
 	const name owner = names.at("owner");
 
-	check (has_auth (owner) || has_auth(get_self()), "Authentication failed. Must have authority from owner: " +
-		owner.to_string() + "@active or " + get_self().to_string() + "@active.");
+	check (has_auth (owner) || has_auth(get_self()), errors::MISSING_AUTHORITY, owner, get_self());
 	
 	qualify_proposer (owner);
 
+	Object header;
+	ObjectBody body;
+	header.id = body.id = next_object_id (scope);
+	time_point_sec expiration;
+	pack_object (header, body, names, strings, assets, time_points, ints, floats, trxs);
+
+	body.strings["client_version"] = config.get_string("client_version");
+	body.strings["contract_version"] = config.get_string("contract_version");
+
+	if (scope == "proposal"_n) {
+		expiration			= time_point_sec(current_time_point()) + config.get_int("voting_duration_sec");
+		if (config.get_int ("native_tally", 0) == 1) {
+			// voted on in this contract; the proposal has no decide ballot
+			check (!vote_transferable(), errors::VOTE_TRANSFERABLE);
+			const asset zero = asset { 0, common::S_VOTE };
+			tally_table t_t (get_self(), get_self().value);
+			t_t.emplace (get_self(), [&](auto &t) {
+				t.proposal_id	= header.id;
+				t.votes_pass	= zero;
+				t.votes_fail	= zero;
+				t.total_weight	= zero;
+			});
+		} else {
+			header.ballot_id	= register_ballot (owner, body.title, body.description, body.content, expiration);
+		}
+		header.status		= "open"_n;
+
+		// on approval, trx_action_contract::trx_action_name (proposal_id) runs inline; see close_proposal
+		if (header.trx_action_contract == name()) {
+			header.trx_action_contract = get_self();
+		}
+		if (header.trx_action_name == name()) {
+			header.trx_action_name = "passprop"_n;
+		}
+		// reserved for proposals created before inline execution; never accepted from a proposer
+		body.trxs.erase ("exec_on_approval");
+	}
+
 	object_table o_t (get_self(), scope.value);
 	o_t.emplace (get_self(), [&](auto &o) {
-		o.id                       	= o_t.available_primary_key();
-		o.names                    	= names;
-		o.strings                  	= strings;
-		o.assets                  	= assets;
-		o.time_points              	= time_points;
-		o.ints                     	= ints;
-		o.floats                   	= floats;
-		o.trxs                     	= trxs;
-
-		config_table      config_s (get_self(), get_self().value);
-   		Config c = config_s.get_or_create (get_self(), Config()); 
-		o.strings["client_version"] = get_string(c.strings, "client_version");
-		o.strings["contract_version"] = get_string(c.strings, "contract_version");
+		o = header;
+	});
 
-		if (scope == "proposal"_n) {
-			name proposal_type	= names.at("type");
-			o.names["ballot_id"]		= register_ballot (owner, strings);
+	if (scope == "proposal"_n) {
+		expiry_table e_t (get_self(), get_self().value);
+		e_t.emplace (get_self(), [&](auto &e) {
+			e.proposal_id	= header.id;
+			e.ballot_id		= header.ballot_id;
+			e.expiration	= expiration;
+			e.quorum_threshold	= get_quorum_threshold();
+		});
+	}
 
-			/* default trx_action_account to dao */
-			if (names.find("trx_action_contract") == names.end()) {
-				o.names["trx_action_contract"] = get_self();
-			}
+	object_body_table b_t (get_self(), scope.value);
+	b_t.emplace (get_self(), [&](auto &b) {
+		b = body;
+	});
+}
+
+// records that member completed the challenge; returns false if it was already recorded
+bool dao::record_completion (const name& member, const uint64_t& challenge_id) {
+	completion_table c_t (get_self(), get_self().value);
+	auto c_index = c_t.get_index<"bymemchlg"_n>();
+	if (c_index.find (completion_key (member, challenge_id)) != c_index.end()) {
+		return false;
+	}
+
+	c_t.emplace (get_self(), [&](auto &c) {
+		c.completion_id	= c_t.available_primary_key();
+		c.member		= member;
+		c.challenge_id	= challenge_id;
+	});
+
+	challenge_count_table cc_t (get_self(), get_self().value);
+	auto cc_itr = cc_t.find (challenge_id);
+	if (cc_itr == cc_t.end()) {
+		cc_t.emplace (get_self(), [&](auto &cc) {
+			cc.challenge_id	= challenge_id;
+			cc.completions	= 1;
+		});
+	} else {
+		cc_t.modify (cc_itr, get_self(), [&](auto &cc) {
+			cc.completions++;
+		});
+	}
+	return true;
+}
 
-			name action_on_approval = name ("passprop");  // default action is 'passprop'
-			if (names.find("trx_action_name") != names.end()) {
-				action_on_approval = names.at("trx_action_name");
+// Ids come from a per-scope counter, so an id is never handed out twice even after rows are
+// erased or compacted into the proposal archive.
+uint64_t dao::next_object_id (const name& scope) {
+	Sequences object_ids (get_self(), "objectids"_n);
+	if (!object_ids.exists (scope)) {
+		// first use in this scope: start after every id already in use
+		object_table o_t (get_self(), scope.value);
+		uint64_t next_id = o_t.available_primary_key();
+
+		// rows still waiting in the legacy table keep their ids when migrated
+		legacy_object_table l_t (get_self(), scope.value);
+		if (l_t.begin() != l_t.end()) {
+			next_id = std::max (next_id, l_t.rbegin()->id + 1);
+		}
+
+		if (scope == "proposal"_n) {
+			archive_table a_t (get_self(), get_self().value);
+			if (a_t.begin() != a_t.end()) {
+				next_id = std::max (next_id, a_t.rbegin()->id + 1);
 			}
+		}
+		object_ids.set (scope, next_id);
+	}
+
+	// the counter holds the next id to hand out
+	const uint64_t id = object_ids.current (scope);
+	object_ids.set (scope, id + 1);
+	return id;
+}
+
+void dao::erase_object (const name& scope, const uint64_t& id) {
+	object_table o_t (get_self(), scope.value);
+	auto o_itr = o_t.find (id);
+	check (o_itr != o_t.end(), errors::OBJECT_NOT_FOUND, scope, id);
+	o_t.erase (o_itr);
+
+	object_body_table b_t (get_self(), scope.value);
+	auto b_itr = b_t.find (id);
+	if (b_itr != b_t.end()) {
+		b_t.erase (b_itr);
+	}
+
+	if (scope == "proposal"_n) {
+		pending_exec_table p_t (get_self(), get_self().value);
+		auto p_itr = p_t.find (id);
+		if (p_itr != p_t.end()) {
+			p_t.erase (p_itr);
+		}
 
-			// this transaction executes if the proposal passes
-			transaction trx (time_point_sec(current_time_point())+ (60 * 60 * 24 * 35));
-			trx.actions.emplace_back(
-				permission_level{get_self(), "active"_n}, 
-				o.names.at("trx_action_contract"), action_on_approval, 
-				std::make_tuple(o.id));
-			trx.delay_sec = 0;
-			o.trxs["exec_on_approval"]      = trx;      
+		tally_table t_t (get_self(), get_self().value);
+		auto t_itr = t_t.find (id);
+		if (t_itr != t_t.end()) {
+			t_t.erase (t_itr);
 		}
-	});      
+	}
 }
 
-void dao::clrdebugs (const uint64_t& starting_id, const uint64_t& batch_size) {
-	check (has_auth ("gba"_n) || has_auth(get_self()), "Requires higher permission.");
-	debug_table d_t (get_self(), get_self().value);
-	auto d_itr = d_t.find (starting_id);
+void dao::pack_object (Object& o,
+						ObjectBody& body,
+						map<string, name>          names,
+						map<string, string>        strings,
+						map<string, asset>         assets,
+						map<string, time_point>    time_points,
+						map<string, uint64_t>      ints,
+						map<string, float>         floats,
+						map<string, transaction>   trxs)
+{
+	o.owner						= take (names, "owner");
+	o.type						= take (names, "type");
+	o.ballot_id					= take (names, "ballot_id");
+	o.status					= take (names, "status");
+	o.fk						= take (ints, "fk", uint64_t (0));
+	o.trx_action_contract		= take (names, "trx_action_contract");
+	o.trx_action_name			= take (names, "trx_action_name");
+
+	body.title					= take (strings, "title");
+	body.description			= take (strings, "description");
+	body.content				= take (strings, "content");
+
+	body.names					= std::move (names);
+	body.strings				= std::move (strings);
+	body.assets					= std::move (assets);
+	body.time_points			= std::move (time_points);
+	body.ints					= std::move (ints);
+	body.floats					= std::move (floats);
+	body.trxs					= std::move (trxs);
+}
+
+void dao::migrateobjs (const name& scope, const uint64_t& batch_size) {
+	require_auth (get_self());
+	check (batch_size > 0, errors::ZERO_BATCH_SIZE);
 
-	while (d_itr->debug_id <= starting_id + batch_size) {
-		d_itr = d_t.erase (d_itr);
+	const name decide_contract = config.get_name("telos_decide_contract");
+	decidespace::decide::ballots_table ballot_t (decide_contract, decide_contract.value);
+
+	legacy_object_table l_t (get_self(), scope.value);
+	object_table o_t (get_self(), scope.value);
+	object_body_table b_t (get_self(), scope.value);
+
+	uint64_t count = 0;
+	auto l_itr = l_t.begin();
+	while (l_itr != l_t.end() && count < batch_size) {
+		check (o_t.find (l_itr->id) == o_t.end(), errors::OBJECT_EXISTS, scope, l_itr->id);
+
+		Object header;
+		ObjectBody body;
+		header.id = body.id			= l_itr->id;
+		pack_object (header, body, l_itr->names, l_itr->strings, l_itr->assets, l_itr->time_points, l_itr->ints, l_itr->floats, l_itr->trxs);
+		header.created_date			= l_itr->created_date;
+		header.updated_date			= l_itr->updated_date;
+		if (scope == "proposal"_n && header.status == name()) {
+			// legacy proposals left in this scope may have been closed already (their deferred
+			// action was not passprop, or it failed), so the status comes from the ballot
+			header.status			= legacy_proposal_status (ballot_t, header.ballot_id);
+		}
+		if (body.trxs.find ("exec_on_approval") != body.trxs.end()) {
+			// the serialized transaction is what runs; an empty action name sends execution to the body
+			header.trx_action_contract	= name();
+			header.trx_action_name		= name();
+		}
+
+		o_t.emplace (get_self(), [&](auto &o) {
+			o = header;
+		});
+		b_t.emplace (get_self(), [&](auto &b) {
+			b = body;
+		});
+
+		l_itr = l_t.erase (l_itr);
+		count++;
 	}
 
-	eosio::transaction out{};
-	out.actions.emplace_back(permission_level{get_self(), "active"_n}, 
-							get_self(), "clrdebugs"_n, 
-							std::make_tuple(d_itr->debug_id, batch_size));
-	out.delay_sec = 1;
-	out.send(get_next_sender_id(), get_self());    
+	if (l_itr != l_t.end()) {
+		reschedule ("migrateobjs"_n, scope, batch_size);
+	}
+}
+
+name dao::legacy_proposal_status (const decidespace::decide::ballots_table& ballot_t, const name& ballot_id) {
+	auto b_itr = ballot_t.find (ballot_id.value);
+	if (b_itr == ballot_t.end() || b_itr->status == "cancelled"_n) {
+		return "failed"_n;
+	}
+	if (b_itr->status == "setup"_n || b_itr->status == "voting"_n) {
+		return "open"_n;
+	}
+
+	// closed or archived; legacy proposals have no quorum snapshot, so the current one is used
+	const Tally tally = ballot_tally (*b_itr);
+	return tally.total_weight >= get_quorum_threshold() && tally.votes_pass > tally.votes_fail ? "passed"_n : "failed"_n;
+}
+
+void dao::clrdebugs (const uint64_t& batch_size) {
+	check (has_auth ("gba"_n) || has_auth(get_self()), errors::HIGHER_PERMISSION);
+	check (batch_size > 0, errors::ZERO_BATCH_SIZE);
+	debug_table d_t (get_self(), get_self().value);
+	if (!eraser.erase (d_t, "clrdebugs"_n, get_self(), 0, std::numeric_limits<uint64_t>::max(), batch_size).done) {
+		reschedule ("clrdebugs"_n, batch_size);
+	}
 }
 
 void dao::addperiod (const time_point& start_date, const time_point& end_date) {
@@ -324,83 +723,426 @@ void dao::addperiod (const time_point& start_date, const time_point& end_date) {
 	bank.addperiod (start_date, end_date);
 }
 
+void dao::addperiods (const vector<std::pair<time_point, time_point>>& periods) {
+	require_auth (get_self());
+	check (periods.size() > 0, errors::EMPTY_LIST, "periods");
+	bank.addperiods (periods);
+}
+
+void dao::setcalendar (const time_point& epoch, const uint64_t& length_sec, 
+						   const uint64_t& count, const uint64_t& first_period_id) {
+	bank.setcalendar (epoch, length_sec, count, first_period_id);
+}
+
+void dao::overperiod (const uint64_t& period_id, const time_point& start_date, const time_point& end_date) {
+	require_auth (get_self());
+	bank.overperiod (period_id, start_date, end_date);
+}
+
+void dao::migperiods (const uint64_t& batch_size) {
+	require_auth (get_self());
+	check (batch_size > 0, errors::ZERO_BATCH_SIZE);
+	if (!bank.migrate_periods (batch_size)) {
+		reschedule ("migperiods"_n, batch_size);
+	}
+}
+
+void dao::getperiod (const time_point& time) {
+	uint64_t period_id = bank.get_period_for (time);
+	check (period_id != common::NO_PERIOD, errors::NO_PERIOD_FOR_TIME);
+
+	Bank::Period period;
+	bank.get_period (period_id, period);
+	print ("{\"period_id\":", period.period_id,
+			",\"start_date\":", period.start_date.sec_since_epoch(),
+			",\"end_date\":", period.end_date.sec_since_epoch(), "}");
+}
+
 void dao::compchalleng (const name& completer, const uint64_t& challenge_id) 
 {
-	check(!is_paused(), "Contract is paused for maintenance. Please try again later.");
+	check (!is_paused(), errors::PAUSED);
 	require_auth(completer);
 
-	object_table o_t_challenge(get_self(), "challenge"_n.value);
-	auto c_itr = o_t_challenge.find(challenge_id);
-	check(c_itr != o_t_challenge.end(), "Challenge does not exist: " + std::to_string(challenge_id));
+	object_body_table b_t_challenge(get_self(), "challenge"_n.value);
+	auto c_itr = b_t_challenge.find(challenge_id);
+	check (c_itr != b_t_challenge.end(), errors::CHALLENGE_NOT_FOUND, challenge_id);
 
-	// check in the completer's list of objects to determine if they have completed this challenge already
 	// TODO: what if a challenge is erased and a second one is created with the same ID
 	member_table m_t (get_self(), get_self().value);
 	auto m_itr = m_t.find (completer.value);
-	check (m_itr != m_t.end(), "Challenge completer is not a member: " + completer.to_string());
-	for (chg_id : m_itr->completed_challenges) {
-		check (challenge_id != chg_id, "Member: ", completer.to_string(), " has already completed challenge id: " + std::to_string(challenge_id));)
+	check (m_itr != m_t.end(), errors::NOT_MEMBER, completer);
+
+	// completions recorded before the completions table existed are moved there on first touch
+	if (!m_itr->completed_challenges.empty()) {
+		for (const auto& chg_id : m_itr->completed_challenges) {
+			record_completion (completer, chg_id);
+		}
+		m_t.modify (m_itr, get_self(), [&](auto &m) {
+			m.completed_challenges.clear();
+		});
 	}
-	m_t.modify (m_itr, get_self(), [&](auto &m) {
-		m.completed_challenges.push_back(challenge_id);
-	});
+
+	check (record_completion (completer, challenge_id), errors::CHALLENGE_COMPLETED, completer, challenge_id);
 
 	string memo{"One time reward for Hypha Challenge. Challenge Name ID: " + std::to_string(challenge_id)};
-	bank.makepayment(-1, completer, o_itr->assets.at("reward_amount"), memo, challenge_id, 1);
-	bank.makepayment(-1, completer, o_itr->assets.at("usd_amount"), memo, challenge_id, 1);
-	bank.makepayment(-1, completer, o_itr->assets.at("vote_amount"), memo, challenge_id, 1);
+	vector<Bank::PaymentRequest> payments;
+	for (const char* key : { "reward_amount", "usd_amount", "vote_amount" }) {
+		payments.push_back (Bank::PaymentRequest { common::NO_PERIOD, completer, c_itr->assets.at(key), memo, challenge_id });
+	}
+	bank.makepayments (payments);
 }
 
 void dao::closeprop(const uint64_t& proposal_id) {
 
-	check ( !is_paused(), "Contract is paused for maintenance. Please try again later.");	
+	check (!is_paused(), errors::PAUSED);	
 
 	object_table o_t (get_self(), "proposal"_n.value);
 	auto o_itr = o_t.find(proposal_id);
-	check (o_itr != o_t.end(), "Scope: " + "proposal"_n.to_string() + "; Object ID: " + std::to_string(proposal_id) + " does not exist.");
-	auto prop = *o_itr;
+	check (o_itr != o_t.end(), errors::OBJECT_NOT_FOUND, "proposal"_n, proposal_id);
+	check (o_itr->status == "open"_n, errors::PROPOSAL_NOT_OPEN, proposal_id, o_itr->status);
+
+	expiry_table e_t (get_self(), get_self().value);
+	auto e_itr = e_t.find (proposal_id);
+
+	if (o_itr->ballot_id == name()) {
+		// natively tallied
+		check (e_itr != e_t.end(), errors::NO_EXPIRATION, proposal_id);
+		check (e_itr->expiration <= current_time_point(), errors::VOTING_NOT_ENDED, proposal_id);
+		tally_table t_t (get_self(), get_self().value);
+		auto t_itr = t_t.find (proposal_id);
+		check (t_itr != t_t.end(), errors::TALLY_NOT_FOUND, proposal_id);
+		close_proposal (o_t, o_itr, *t_itr, e_itr->quorum_threshold, true);
+		return;
+	}
+
+	const name decide_contract = config.get_name("telos_decide_contract");
+	decidespace::decide::ballots_table b_t (decide_contract, decide_contract.value);
+	auto b_itr = b_t.find (o_itr->ballot_id.value);
+	check (b_itr != b_t.end(), errors::BALLOT_NOT_FOUND, o_itr->ballot_id);
+
+	// proposals opened before quorum snapshots have no expiry row; they use the current supply
+	close_proposal (o_t, o_itr, ballot_tally (*b_itr), 
+		e_itr != e_t.end() ? e_itr->quorum_threshold : get_quorum_threshold(), true);
+}
+
+void dao::vote (const name& voter, const uint64_t& proposal_id, const name& option) {
+
+	check (!is_paused(), errors::PAUSED);	
+	require_auth (voter);
+	check (option == "pass"_n || option == "fail"_n, errors::INVALID_VOTE_OPTION, option);
+
+	object_table o_t (get_self(), "proposal"_n.value);
+	auto o_itr = o_t.find (proposal_id);
+	check (o_itr != o_t.end(), errors::OBJECT_NOT_FOUND, "proposal"_n, proposal_id);
+	check (o_itr->status == "open"_n, errors::PROPOSAL_NOT_OPEN, proposal_id, o_itr->status);
+
+	tally_table t_t (get_self(), get_self().value);
+	auto t_itr = t_t.find (proposal_id);
+	check (t_itr != t_t.end(), errors::DECIDE_BALLOT, proposal_id);
+
+	expiry_table e_t (get_self(), get_self().value);
+	auto e_itr = e_t.find (proposal_id);
+	check (e_itr != e_t.end(), errors::NO_EXPIRATION, proposal_id);
+	check (current_time_point() < e_itr->expiration, errors::VOTING_ENDED, proposal_id);
+
+	// votes are weighted by the voter's liquid VOTE balance in telos decide at the time of voting.
+	// That is only sound while VOTE cannot be transferred: otherwise one balance could vote,
+	// move to another account and vote again. The weight is not snapshotted, so refuse instead.
+	check (!vote_transferable(), errors::VOTE_TRANSFERABLE);
+	const name decide_contract = config.get_name("telos_decide_contract");
+	decidespace::decide::voters_table v_t (decide_contract, voter.value);
+	auto v_itr = v_t.find (common::S_VOTE.code().raw());
+	check (v_itr != v_t.end() && v_itr->liquid.amount > 0, errors::NO_VOTE_BALANCE, voter);
+	const asset weight = v_itr->liquid;
+
+	receipt_table r_t (get_self(), proposal_id);
+	auto r_itr = r_t.find (voter.value);
+
+	t_t.modify (t_itr, get_self(), [&](auto &t) {
+		if (r_itr != r_t.end()) {
+			// a changed vote replaces the previous one
+			(r_itr->option == "pass"_n ? t.votes_pass : t.votes_fail) -= r_itr->weight;
+			t.total_weight -= r_itr->weight;
+		} else {
+			t.voters++;
+		}
+		(option == "pass"_n ? t.votes_pass : t.votes_fail) += weight;
+		t.total_weight += weight;
+	});
+
+	if (r_itr == r_t.end()) {
+		r_t.emplace (voter, [&](auto &r) {
+			r.voter		= voter;
+			r.option	= option;
+			r.weight	= weight;
+		});
+	} else {
+		r_t.modify (r_itr, voter, [&](auto &r) {
+			r.option	= option;
+			r.weight	= weight;
+			r.vote_time	= current_time_point();
+		});
+	}
+}
+
+void dao::closeprops (const uint64_t& max_count) {
+
+	check (!is_paused(), errors::PAUSED);	
+	check (max_count > 0, errors::ZERO_BATCH_SIZE, "max_count");
+
+	const name decide_contract = config.get_name("telos_decide_contract");
+	decidespace::decide::ballots_table b_t (decide_contract, decide_contract.value);
+	auto end_index = b_t.get_index<"byendtime"_n>();
+
+	object_table o_t (get_self(), "proposal"_n.value);
+	expiry_table e_t (get_self(), get_self().value);
+	auto ballot_index = e_t.get_index<"byballot"_n>();
+
+	// the cursor is the (end time, name) of the last ballot examined, which is its position in
+	// byendtime; many ballots can end in the same second. Without a name it is the end time of
+	// the first ballot not yet examined.
+	uint64_t cursor_time = sequences.exists ("closecursor"_n) ? sequences.current ("closecursor"_n) : 0;
+	uint64_t cursor_ballot = sequences.exists ("closeballot"_n) ? sequences.current ("closeballot"_n) : 0;
+	const uint64_t now = current_time_point().sec_since_epoch();
+
+	// byendtime holds the ballots of every publisher; nothing before this contract's earliest
+	// expiry can belong to an open proposal, so start there instead of walking them
+	auto expiration_index = e_t.get_index<"byexpiration"_n>();
+	if (expiration_index.begin() == expiration_index.end()) {
+		LOG_INFO (logger, "closeprops: no proposal is waiting to be closed.");
+		return;
+	}
+	if (cursor_time < expiration_index.begin()->by_expiration()) {
+		cursor_time = expiration_index.begin()->by_expiration();
+		cursor_ballot = 0;
+	}
 
-	config_table      config_s (get_self(), get_self().value);
-   	Config c = config_s.get_or_create (get_self(), Config());  
+	auto b_itr = end_index.lower_bound (cursor_time);
+	if (cursor_ballot != 0) {
+		auto last_itr = b_t.find (cursor_ballot);
+		if (last_itr != b_t.end() && last_itr->by_end_time() == cursor_time) {
+			b_itr = std::next (end_index.iterator_to (*last_itr));
+		} else {
+			// the last ballot is gone or was moved; skip the rest of its second by name
+			while (b_itr != end_index.end() && b_itr->by_end_time() == cursor_time && b_itr->ballot_name.value <= cursor_ballot) {
+				b_itr++;
+			}
+		}
+	}
 
-	decidespace::decide::ballots_table b_t (c.names.at("telos_decide_contract"), c.names.at("telos_decide_contract").value);
-	auto b_itr = b_t.find (prop.names.at("ballot_id").value);
-	check (b_itr != b_t.end(), "ballot_id: " + prop.names.at("ballot_id").to_string() + " not found.");
+	uint64_t examined = 0, closed = 0, last_time = 0, last_ballot = 0;
+	while (b_itr != end_index.end() && b_itr->by_end_time() <= now && examined < max_count) {
+		auto e_itr = ballot_index.find (b_itr->ballot_name.value);
+		if (e_itr != ballot_index.end()) {
+			auto o_itr = o_t.find (e_itr->proposal_id);
+			if (o_itr == o_t.end() || o_itr->status != "open"_n || o_itr->ballot_id != b_itr->ballot_name) {
+				// the proposal was erased or closed some other way
+				ballot_index.erase (e_itr);
+			} else if (b_itr->status != "voting"_n) {
+				// closevoting would fail and undo the whole batch; leave it to closeprop
+				LOG_WARN (logger, "Skipping proposal ", o_itr->id, "; ballot status is ", b_itr->status);
+			} else {
+				close_proposal (o_t, o_itr, ballot_tally (*b_itr), e_itr->quorum_threshold, false);
+				closed++;
+			}
+		}
+		last_time = b_itr->by_end_time();
+		last_ballot = b_itr->ballot_name.value;
+		b_itr++;
+		examined++;
+	}
 
-	decidespace::decide::treasuries_table t_t (c.names.at("telos_decide_contract"), c.names.at("telos_decide_contract").value);
+	if (examined > 0) {
+		sequences.set ("closecursor"_n, last_time);
+		sequences.set ("closeballot"_n, last_ballot);
+	}
+	LOG_INFO (logger, "closeprops examined ", examined, " ballots and closed ", closed, " proposals.");
+}
+
+void dao::crank (const uint64_t& max_work) {
+
+	check (!is_paused(), errors::PAUSED);	
+	check (max_work > 0, errors::ZERO_BATCH_SIZE, "max_work");
+
+	const name decide_contract = config.get_name("telos_decide_contract");
+	decidespace::decide::ballots_table b_t (decide_contract, decide_contract.value);
+	object_table o_t (get_self(), "proposal"_n.value);
+	tally_table t_t (get_self(), get_self().value);
+
+	expiry_table e_t (get_self(), get_self().value);
+	auto expiration_index = e_t.get_index<"byexpiration"_n>();
+	const uint64_t now = current_time_point().sec_since_epoch();
+
+	uint64_t work = 0, closed = 0;
+	auto e_itr = expiration_index.begin();
+	while (e_itr != expiration_index.end() && e_itr->by_expiration() <= now && work < max_work) {
+		auto o_itr = o_t.find (e_itr->proposal_id);
+		const bool open = o_itr != o_t.end() && o_itr->status == "open"_n && o_itr->ballot_id == e_itr->ballot_id;
+
+		if (e_itr->ballot_id == name()) {
+			// natively tallied; the expiration is the end of voting
+			auto t_itr = t_t.find (e_itr->proposal_id);
+			if (!open || t_itr == t_t.end()) {
+				LOG_WARN (logger, "Dropping expiry for proposal ", e_itr->proposal_id);
+				e_itr = expiration_index.erase (e_itr);
+			} else {
+				auto next_itr = std::next (e_itr);
+				close_proposal (o_t, o_itr, *t_itr, e_itr->quorum_threshold, false);
+				e_itr = next_itr;
+				closed++;
+			}
+			work++;
+			continue;
+		}
+
+		auto b_itr = b_t.find (e_itr->ballot_id.value);
+		if (b_itr != b_t.end() && b_itr->by_end_time() > now) {
+			// the ballot closes later than queued; leave the entry for a later crank
+			e_itr++;
+		} else if (!open || b_itr == b_t.end() || b_itr->status != "voting"_n) {
+			// nothing this action can close; drop the entry so it does not block the queue
+			LOG_WARN (logger, "Dropping expiry for proposal ", e_itr->proposal_id, ", ballot ", e_itr->ballot_id);
+			e_itr = expiration_index.erase (e_itr);
+		} else {
+			// close_proposal removes the entry
+			auto next_itr = std::next (e_itr);
+			close_proposal (o_t, o_itr, ballot_tally (*b_itr), e_itr->quorum_threshold, false);
+			e_itr = next_itr;
+			closed++;
+		}
+		work++;
+	}
+
+	LOG_INFO (logger, "crank examined ", work, " expiries and closed ", closed, " proposals.");
+}
+
+asset dao::get_quorum_threshold () {
+	const name decide_contract = config.get_name("telos_decide_contract");
+	decidespace::decide::treasuries_table t_t (decide_contract, decide_contract.value);
 	auto t_itr = t_t.find (common::S_VOTE.code().raw());
-	check (t_itr != t_t.end(), "Treasury: " + common::S_VOTE.code().to_string() + " not found.");
+	check (t_itr != t_t.end(), errors::TREASURY_NOT_FOUND, common::S_VOTE.code());
 
-	asset quorum_threshold = adjust_asset(t_itr->supply, 0.20000000);  // quorum of 20%
-	map<name, asset> votes = b_itr->options;
-	asset votes_pass = votes.at("pass"_n);
-	asset votes_fail = votes.at("fail"_n);
+	// quorum_bps is the share of the VOTE supply, in basis points, that must vote (default 20%)
+	const uint64_t quorum_bps = config.get_int ("quorum_bps", 2000);
+	check (quorum_bps <= common::BASIS_POINTS, errors::QUORUM_TOO_HIGH, quorum_bps);
+	return common::apply_bps (t_itr->supply, quorum_bps);
+}
+
+bool dao::vote_transferable () {
+	const name decide_contract = config.get_name("telos_decide_contract");
+	decidespace::decide::treasuries_table t_t (decide_contract, decide_contract.value);
+	auto t_itr = t_t.find (common::S_VOTE.code().raw());
+	check (t_itr != t_t.end(), errors::TREASURY_NOT_FOUND, common::S_VOTE.code());
 
-	string debug_str = " Total Vote Weight: " + b_itr->total_raw_weight.to_string() + "\n";
-	debug_str = debug_str + " Total Supply: " + t_itr->supply.to_string() + "\n"; 
-	debug_str = debug_str + " Quorum Threshold: " + quorum_threshold.to_string() + "\n";	
-	debug_str = debug_str + " Votes Passing: " + votes_pass.to_string() + "\n";
-	debug_str = debug_str + " Votes Failing: " + votes_fail.to_string() + "\n";
+	auto s_itr = t_itr->settings.find ("transferable"_n);
+	return s_itr != t_itr->settings.end() && s_itr->second;
+}
+
+dao::Tally dao::ballot_tally (const decidespace::decide::ballot& ballot) {
+	Tally tally;
+	tally.votes_pass	= ballot.options.at("pass"_n);
+	tally.votes_fail	= ballot.options.at("fail"_n);
+	tally.total_weight	= ballot.total_raw_weight;
+	tally.voters		= ballot.total_voters;
+	return tally;
+}
+
+void dao::close_proposal (object_table& o_t, 
+						  object_table::const_iterator o_itr, 
+						  const Tally& tally,
+						  const asset& quorum_threshold,
+						  const bool& execute) {
+
+	const uint64_t proposal_id = o_itr->id;
+	const name ballot_id = o_itr->ballot_id;
 
 	bool passed = false;
-	if (b_itr->total_raw_weight >= quorum_threshold && 			// must meet quorum
-		votes_pass > votes_fail) {  // must have 50% of the vote power
-		debug_str = debug_str + "Proposal passed. Executing transaction. ";
+	if (tally.total_weight >= quorum_threshold && 			// must meet quorum
+		tally.votes_pass > tally.votes_fail) {  // must have 50% of the vote power
 		passed = true;
-		prop.trxs.at("exec_on_approval").send(current_block_time().to_time_point().sec_since_epoch(), get_self());		
+
+		if (execute) {
+			execute_proposal (*o_itr);
+		} else {
+			pending_exec_table p_t (get_self(), get_self().value);
+			p_t.emplace (get_self(), [&](auto &p) {
+				p.proposal_id = proposal_id;
+			});
+		}
+	}
+
+	// one in-place update of the header; the proposal keeps its id and scope
+	o_t.modify (o_itr, get_self(), [&](auto &o) {
+		o.status = passed ? "passed"_n : "failed"_n;
+		o.updated_date = current_time_point();
+	});
+
+	expiry_table e_t (get_self(), get_self().value);
+	auto e_itr = e_t.find (proposal_id);
+	if (e_itr != e_t.end()) {
+		e_t.erase (e_itr);
+	}
+
+	// natively tallied proposals have no ballot; their tally row is kept as the record of the vote
+	if (ballot_id != name()) {
+		action (
+			permission_level{get_self(), "active"_n},
+			config.get_name("telos_decide_contract"), "closevoting"_n,
+			std::make_tuple(ballot_id, true))
+		.send();
+	}
+
+	LOG_DEBUG (logger, " Total Vote Weight: ", tally.total_weight, "\n",
+		" Quorum Threshold: ", quorum_threshold, "\n",
+		" Votes Passing: ", tally.votes_pass, "\n",
+		" Votes Failing: ", tally.votes_fail, "\n",
+		passed ? (execute ? "Proposal passed. Executing transaction. " : "Proposal passed. Execution queued. ") : "",
+		"Ballot ID read from prop for closing ballot: ", ballot_id, "\n");
+}
+
+void dao::execute_proposal (const Object& proposal) {
+	if (proposal.trx_action_name != name()) {
+		// runs after the calling action, once its status changes are written
+		action (
+			permission_level{get_self(), "active"_n},
+			proposal.trx_action_contract, proposal.trx_action_name,
+			std::make_tuple(proposal.id))
+		.send();
+		return;
+	}
+
+	// only proposals migrated with a serialized deferred transaction get here and decode the body
+	object_body_table body_t (get_self(), "proposal"_n.value);
+	auto b_itr = body_t.find (proposal.id);
+	check (b_itr != body_t.end(), errors::OBJECT_BODY_NOT_FOUND, "proposal"_n, proposal.id);
+	auto trx_itr = b_itr->trxs.find ("exec_on_approval");
+	if (trx_itr != b_itr->trxs.end()) {
+		trx_itr->second.send(get_next_sender_id(), get_self());
 	} else {
-		change_scope ("proposal"_n, proposal_id, "failedprops"_n, false);
-		change_scope ("proposal"_n, proposal_id, "proparchive"_n, true);
+		LOG_WARN (logger, "Proposal ", proposal.id, " has no action to execute");
 	}
+}
 
-	debug_str = debug_str + string ("Ballot ID read from prop for closing ballot: " + prop.names.at("ballot_id").to_string() + "\n");
-	action (
-		permission_level{get_self(), "active"_n},
-		c.names.at("telos_decide_contract"), "closevoting"_n,
-		std::make_tuple(prop.names.at("ballot_id"), true))
-	.send();
+void dao::execprop (const uint64_t& proposal_id) {
+
+	check (!is_paused(), errors::PAUSED);	
+
+	// if the proposal's action fails, this whole action reverts and the row stays for a retry
+	pending_exec_table p_t (get_self(), get_self().value);
+	auto p_itr = p_t.find (proposal_id);
+	check (p_itr != p_t.end(), errors::NO_PENDING_EXECUTION, proposal_id);
+	p_t.erase (p_itr);
 
-	debug (debug_str);
+	object_table o_t (get_self(), "proposal"_n.value);
+	auto o_itr = o_t.find (proposal_id);
+	if (o_itr == o_t.end()) {
+		// erased since it was queued; failing would put the row back for good
+		LOG_WARN (logger, "Dropping queued execution of erased proposal ", proposal_id);
+		return;
+	}
+	check (o_itr->status == "passed"_n, errors::PROPOSAL_NOT_PASSED, proposal_id, o_itr->status);
+
+	execute_proposal (*o_itr);
 }
 
 void dao::passprop (const uint64_t& proposal_id) {
@@ -408,13 +1150,66 @@ void dao::passprop (const uint64_t& proposal_id) {
 
 	object_table o_t(get_self(), "proposal"_n.value);
 	auto o_itr = o_t.find(proposal_id);
-	check (o_itr != o_t.end(), "Proposal ID does not exist: " + std::to_string(proposal_id));
-	check (o_itr->names.find("type") != o_itr->names.end(), "Proposal object does not have a type to promote object to. proposal_id: " + std::to_string(proposal_id));
+	check (o_itr != o_t.end(), errors::OBJECT_NOT_FOUND, "proposal"_n, proposal_id);
+	check (o_itr->status == "passed"_n, errors::PROPOSAL_NOT_PASSED, proposal_id, o_itr->status);
+	check (o_itr->type != name(), errors::PROPOSAL_WITHOUT_TYPE, proposal_id);
 
-	vector<name> new_scopes = {o_itr->names.at("type"), name("proparchive")};
-	change_scope("proposal"_n, proposal_id, new_scopes, true);
+	change_scope("proposal"_n, proposal_id, o_itr->type);
 }
 
+void dao::archiveprops (const uint64_t& max_count, const bool& compact) {
+	require_auth (get_self());
+
+	object_table o_t (get_self(), "proposal"_n.value);
+	object_body_table b_t (get_self(), "proposal"_n.value);
+	archive_table a_t (get_self(), get_self().value);
+	pending_exec_table p_t (get_self(), get_self().value);
+	tally_table t_t (get_self(), get_self().value);
+	auto status_index = o_t.get_index<"bystatus"_n>();
+
+	uint64_t count = 0;
+	for (const name& status : { "passed"_n, "failed"_n, "archived"_n }) {
+		// archived rows only need attention when compacting
+		if (status == "archived"_n && !compact) {
+			break;
+		}
+
+		auto s_itr = status_index.lower_bound (status.value);
+		while (s_itr != status_index.end() && s_itr->status == status && count < max_count) {
+			if (p_t.find (s_itr->id) != p_t.end()) {
+				// passed but not executed yet; execprop needs it as it is
+				s_itr++;
+			} else if (compact) {
+				a_t.emplace (get_self(), [&](auto &a) {
+					a.id				= s_itr->id;
+					a.owner				= s_itr->owner;
+					a.type				= s_itr->type;
+					a.ballot_id			= s_itr->ballot_id;
+					a.status			= status;
+					a.created_date		= s_itr->created_date;
+					a.closed_date		= s_itr->updated_date;
+				});
+
+				auto b_itr = b_t.find (s_itr->id);
+				if (b_itr != b_t.end()) {
+					b_t.erase (b_itr);
+				}
+				auto t_itr = t_t.find (s_itr->id);
+				if (t_itr != t_t.end()) {
+					t_t.erase (t_itr);
+				}
+				s_itr = status_index.erase (s_itr);
+			} else {
+				auto next_itr = std::next (s_itr);
+				status_index.modify (s_itr, get_self(), [&](auto &o) {
+					o.status = "archived"_n;
+				});
+				s_itr = next_itr;
+			}
+			count++;
+		}
+	}
+}
 
 void dao::qualify_proposer (const name& proposer) {
 	// Should we require that users hold Hypha before they are allowed to propose?  Disabled for now.
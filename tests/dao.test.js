@@ -8,6 +8,13 @@ const EOSIOTOKEN_WASM = "../hyphadac/dao/eosiotoken/eosiotoken.wasm";
 const EOSIOTOKEN_ABI = "../hyphadac/dao/eosiotoken/eosiotoken.abi";
 const TRAIL_WASM = "../telos.contracts/eosio.trail/eosio.trail.wasm";
 const TRAIL_ABI = "../telos.contracts/eosio.trail/eosio.trail.abi";
+// the native voting suite deploys this repository's own build (mkdir build && cd build && cmake .. && make)
+const BUILD_DAO_WASM = "build/dao/dao.wasm";
+const BUILD_DAO_ABI = "build/dao/dao.abi";
+const DECIDE_WASM = "../telos.contracts/telos.decide/telos.decide.wasm";
+const DECIDE_ABI = "../telos.contracts/telos.decide/telos.decide.abi";
+
+const sleep = ms => new Promise(resolve => setTimeout(resolve, ms));
 
 describe("DAO Testing", function() {
   this.timeout(150000);
@@ -192,3 +199,159 @@ describe("DAO Testing", function() {
 
   });
 });
+
+describe("Native voting", function() {
+  const VOTING_DURATION_SEC = 3;
+  let daoContract, decideContract;
+  let daoAccount, eosTokenAccount, decideAccount;
+  let member1, member2, member3;
+
+  const getRows = async (table, scope = daoAccount.name) => {
+    const result = await daoContract.provider.eos.getTableRows({
+      code: daoAccount.name,
+      scope: scope,
+      table: table,
+      json: true
+    });
+    return result.rows;
+  };
+
+  const createProposal = async (owner, title) => {
+    await daoContract.create(
+      "proposal",
+      [ { key: "owner", value: owner.name }, { key: "type", value: "role" } ],
+      [ { key: "title", value: title }, { key: "description", value: title } ],
+      [], [], [], [], [], { from: owner });
+    const proposals = await getRows("objectsv2", "proposal");
+    return proposals[proposals.length - 1].id;
+  };
+
+  const assertFails = async (promise, code) => {
+    try {
+      await promise;
+    } catch (e) {
+      assert.ok(JSON.stringify(e).includes(code), "expected " + code + ", got " + JSON.stringify(e));
+      return;
+    }
+    assert.fail("expected " + code);
+  };
+
+  before(async () => {
+    const accounts = await eoslime.Account.createRandoms(6);
+    [daoAccount, eosTokenAccount, decideAccount, member1, member2, member3] = accounts;
+
+    for (const account of [daoAccount, decideAccount]) {
+      await account.addPermission(account.name, "active", account.name, "eosio.code");
+    }
+    daoContract = await eoslime.AccountDeployer.deploy(BUILD_DAO_WASM, BUILD_DAO_ABI, daoAccount);
+    await eoslime.AccountDeployer.deploy(EOSIOTOKEN_WASM, EOSIOTOKEN_ABI, eosTokenAccount);
+    decideContract = await eoslime.AccountDeployer.deploy(DECIDE_WASM, DECIDE_ABI, decideAccount);
+    await decideContract.init("v2.0.0", { from: decideAccount });
+    await decideContract.updatefee("treasury", "0.0000 TLOS", { from: decideAccount });
+
+    // VOTEPOW is not transferable by default, which native voting relies on
+    await decideContract.newtreasury(daoAccount.name, "1000000.00 VOTEPOW", "public", { from: daoAccount });
+    for (const [member, amount] of [[member1, "100.00 VOTEPOW"], [member2, "50.00 VOTEPOW"], [member3, "20.00 VOTEPOW"]]) {
+      await decideContract.regvoter(member.name, "2,VOTEPOW", null, { from: member });
+      await decideContract.mint(member.name, amount, "", { from: daoAccount });
+    }
+
+    await daoContract.setconfig(
+      [ { key: "reward_token_contract", value: eosTokenAccount.name }, 
+        { key: "telos_decide_contract", value: decideAccount.name },
+        { key: "last_ballot_id", value: "hypha1" } ],
+      [ { key: "client_version", value: "test" }, { key: "contract_version", value: "test" } ],
+      [], [],
+      [ { key: "voting_duration_sec", value: VOTING_DURATION_SEC }, { key: "paused", value: 0 },
+        { key: "quorum_bps", value: 2000 }, { key: "native_tally", value: 1 } ],
+      [], [], { from: daoAccount });
+  });
+
+  it("Should tally native votes", async () => {
+    const proposalId = await createProposal(member1, "Native role");
+
+    await daoContract.vote(member1.name, proposalId, "pass", { from: member1 });
+    await daoContract.vote(member2.name, proposalId, "fail", { from: member2 });
+
+    const tally = (await getRows("tallies")).find(t => t.proposal_id == proposalId);
+    assert.equal(tally.votes_pass, "100.00 VOTEPOW");
+    assert.equal(tally.votes_fail, "50.00 VOTEPOW");
+    assert.equal(tally.total_weight, "150.00 VOTEPOW");
+    assert.equal(tally.voters, 2);
+    assert.equal((await getRows("receipts", String(proposalId))).length, 2);
+  });
+
+  it("Should replace a changed vote", async () => {
+    const proposalId = (await getRows("tallies"))[0].proposal_id;
+
+    await daoContract.vote(member2.name, proposalId, "pass", { from: member2 });
+    await assertFails(daoContract.vote(member3.name, proposalId, "abstain", { from: member3 }), "E28");
+
+    const tally = (await getRows("tallies")).find(t => t.proposal_id == proposalId);
+    assert.equal(tally.votes_pass, "150.00 VOTEPOW");
+    assert.equal(tally.votes_fail, "0.00 VOTEPOW");
+    assert.equal(tally.total_weight, "150.00 VOTEPOW");
+    assert.equal(tally.voters, 2);
+
+    const receipt = (await getRows("receipts", String(proposalId))).find(r => r.voter == member2.name);
+    assert.equal(receipt.option, "pass");
+  });
+
+  it("Should close a passed proposal and execute it", async () => {
+    const proposalId = (await getRows("tallies"))[0].proposal_id;
+    await assertFails(daoContract.closeprop(proposalId, { from: member1 }), "E25");
+
+    await sleep((VOTING_DURATION_SEC + 1) * 1000);
+    await assertFails(daoContract.vote(member3.name, proposalId, "pass", { from: member3 }), "E26");
+    await daoContract.closeprop(proposalId, { from: member1 });
+
+    const proposal = (await getRows("objectsv2", "proposal")).find(o => o.id == proposalId);
+    assert.equal(proposal.status, "passed");
+    assert.equal((await getRows("expiries")).filter(e => e.proposal_id == proposalId).length, 0);
+    // passprop ran inline and promoted the proposal into the role scope
+    assert.equal((await getRows("objectsv2", "role")).length, 1);
+  });
+
+  it("Should leave execution of proposals closed by crank to execprop", async () => {
+    const passingId = await createProposal(member1, "Cranked role");
+    const failingId = await createProposal(member1, "Rejected role");
+    await daoContract.vote(member1.name, passingId, "pass", { from: member1 });
+    await daoContract.vote(member1.name, failingId, "fail", { from: member1 });
+
+    await sleep((VOTING_DURATION_SEC + 1) * 1000);
+    await daoContract.crank(10, { from: member3 });
+
+    const proposals = await getRows("objectsv2", "proposal");
+    assert.equal(proposals.find(o => o.id == passingId).status, "passed");
+    assert.equal(proposals.find(o => o.id == failingId).status, "failed");
+    assert.equal((await getRows("expiries")).length, 0);
+    assert.deepEqual((await getRows("pendingexecs")).map(p => p.proposal_id), [passingId]);
+    assert.equal((await getRows("objectsv2", "role")).length, 1);
+
+    await daoContract.execprop(passingId, { from: member3 });
+    assert.equal((await getRows("pendingexecs")).length, 0);
+    assert.equal((await getRows("objectsv2", "role")).length, 2);
+    await assertFails(daoContract.execprop(passingId, { from: member3 }), "E46");
+  });
+
+  it("Should compact closed proposals and clear their votes", async () => {
+    const closedIds = (await getRows("objectsv2", "proposal")).map(o => o.id);
+
+    await daoContract.archiveprops(10, true, { from: daoAccount });
+
+    assert.equal((await getRows("objectsv2", "proposal")).length, 0);
+    assert.deepEqual((await getRows("proparchive")).map(a => a.id), closedIds);
+    assert.equal((await getRows("tallies")).length, 0);
+
+    for (const proposalId of closedIds) {
+      await daoContract.clrreceipts(proposalId, 10, { from: daoAccount });
+      assert.equal((await getRows("receipts", String(proposalId))).length, 0);
+    }
+
+    // ids of compacted proposals are not handed out again
+    const nextId = await createProposal(member1, "After compaction");
+    assert.ok(nextId > Math.max(...closedIds));
+    const tally = (await getRows("tallies")).find(t => t.proposal_id == nextId);
+    assert.equal(tally.voters, 0);
+  });
+});